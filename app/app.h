@@ -14,8 +14,14 @@
 
 #include "app_cmd\app_cmd.h"
 #include "app_player\app_player.h"
+#include "app_player\app_player_resample.h"
+#include "app_player\app_player_frc.h"
+#include "app_player\app_player_input.h"
+#include "app_player\app_player_hold.h"
+#include "app_player\app_player_drv.h"
 #include "app_plimit\app_plimit.h"
 #include "app_plimit\app_plimit_cmd.h"
 #include "app_plimit\app_plimit_db.h"
+#include "app_telem\app_telem.h"
 
 #endif /* APP_INCLUDE_APP_H_ */
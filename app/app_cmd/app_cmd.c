@@ -9,14 +9,25 @@
  */
 
 #include "app.h"
+#include "bsp.h"
 #include "hal.h"
 #include "string.h"
+#include "stdlib.h"
 
 /*****************************************************************************
  * Internal Defines.
  *****************************************************************************/
 #define CMD_PRINT         printf
 
+/*****************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+#define CMD_I2C_WIN_AMOUNT  8
+static tI2cSlave_Window Cmd_I2cWindow[CMD_I2C_WIN_AMOUNT];
+
+//I2C slave counters at last "i2c" command , for throughput.
+static uint32_t Cmd_I2cTick, Cmd_I2cRx, Cmd_I2cTx;
+
 /*****************************************************************************
  * Internal Functions.
  *****************************************************************************/
@@ -45,20 +56,54 @@ void Cmd_I2c_puts(uint8_t *s, uint16_t len)
     I2cSlave_puts(s, len);
 }
 
+/*! Fill 1 read only register window , return next window. */
+tI2cSlave_Window *Cmd_I2c_map(tI2cSlave_Window *win, uint16_t addr, void *data, uint16_t size)
+{
+    win->Addr = addr;
+    win->Size = size;
+    win->Data = data;
+    win->Access = I2C_S_WIN_READ;
+    return win + 1;
+}
+
 /*****************************************************************************
  * External Functions.
  *****************************************************************************/
+void App_Cmd_init(void)
+{
+    tPlimit_Data *data = APP_PLIMIT_getData();
+    tI2cSlave_Window *win = Cmd_I2cWindow;
+
+    win = Cmd_I2c_map(win, CMD_I2C_PLIMIT_DUTY, data->Duty, sizeof(data->Duty));
+    win = Cmd_I2c_map(win, CMD_I2C_PLIMIT_LIMIT, data->Limit, sizeof(data->Limit));
+    win = Cmd_I2c_map(win, CMD_I2C_PLIMIT_TEMP, data->TempDelta, sizeof(data->TempDelta));
+    win = Cmd_I2c_map(win, CMD_I2C_PLIMIT_SAFE, data->TempSafe, sizeof(data->TempSafe));
+    win = Cmd_I2c_map(win, CMD_I2C_PLIMIT_PARAM, APP_PLIMIT_getParam(), sizeof(tPlimit_Param));
+    win = Cmd_I2c_map(win, CMD_I2C_IN_STAT, App_Player_Input_getStat(), sizeof(tPlayer_InStat));
+    win = Cmd_I2c_map(win, CMD_I2C_DRV_STAT, App_Player_Drv_getStatus(), sizeof(tPlayer_DrvStatus));
+    win = Cmd_I2c_map(win, CMD_I2C_IW_STAT, Iw7027_getStatus(), sizeof(tIw7027_Status));
+    I2cSlave_setWindow(Cmd_I2cWindow, win - Cmd_I2cWindow);
+}
+
 void App_Cmd_I2c(void)
 {
-    ;
+    static uint8_t cmd[I2C_S_MBOX_SIZE];   //Larger than C stack , main loop only.
+
+    //Register windows are served by I2C ISR , only mailbox commands are handled here.
+    if (Cmd_I2c_gets(cmd))
+    {
+        APP_PLIMIT_Cmd(cmd);
+    }
 }
 
 void App_Cmd_Uart(void)
 {
-    uint8_t cmd[256];
-    uint8_t size;
+    static uint8_t cmd[UART_RX_BUF_SIZE + 1];  //Larger than C stack , main loop only.
+    uint16_t size;
     if (size = Cmd_Uart_getl(cmd))
     {
+        cmd[size] = 0x00;   //Arguments are parsed as string.
+
         if (size == 1) //Pure new line.
         {
             CMD_PRINT("\r\n");
@@ -75,11 +120,103 @@ void App_Cmd_Uart(void)
         {
             CMD_PRINT("\r\n Jump to PLIMIT CMD");
         }
+        else if (!memcmp(cmd, "iwstat", 6))
+        {
+            //Print status table of IW7027 background monitor , no SPI access.
+            tIw7027_Status *stat = Iw7027_getStatus();
+            uint16_t i, j;
+
+            CMD_PRINT("\r\n IW7027 Status , Monitor = %d , Fault = %x , REG = [%x]~[%x]", stat->Enable, stat->Fault,
+                    IW7027_MON_BASE, IW7027_MON_BASE + IW7027_MON_SIZE - 1);
+            for (i = 0; i < Iw7027_getDevAmount(); i++)
+            {
+                CMD_PRINT("\r\n IW_%d (%d) :", i, stat->ScanCount[i]);
+                for (j = 0; j < IW7027_MON_SIZE; j++)
+                {
+                    CMD_PRINT(" %x", stat->Reg[i][j]);
+                }
+            }
+
+            tIw7027_FreqStat *freq = Iw7027_getFreqStat();
+            CMD_PRINT("\r\n Freq = %dHz , switch = %d , timeout = %d , wait = %dus",
+                    freq->Freq, freq->SwitchCount, freq->TimeoutCount, freq->WaitUs);
+
+            tIw7027_InitStat *init = Iw7027_getInitStat();
+            CMD_PRINT("\r\n Init = %lu us , reset = %lu us , table = %lu us (%d burst) , lock = %lu us , ID fail = %x",
+                    init->TotalUs, init->ResetUs, init->TableUs, init->TableWrite, init->LockUs, init->IdFail);
+        }
+        else if (!memcmp(cmd, "telem", 5))
+        {
+            //telem [mask (hex) , TELEM_XXX] [decimation] , binary telemetry stream , mask 0 = stop.
+            char *arg;
+            uint8_t mask = strtoul((char *) &cmd[5], &arg, 16);
+            uint8_t decimation = strtoul(arg, 0, 10);
+            App_Telem_config(mask, decimation);
+            CMD_PRINT("\r\n Telemetry mask = %x , decimation = %d", mask, decimation);
+        }
+        else if (!memcmp(cmd, "baud", 4))
+        {
+            //baud [baudrate] , TX ring is sent at old baudrate first , no argument = print setting only.
+            unsigned long baudrate = strtoul((char *) &cmd[4], 0, 10);
+            int err = baudrate ? Uart_setBaud(baudrate) : 0;
+            tUart_Baud *baud = Uart_getBaud();
+            if (baudrate && (baud->Baudrate != baudrate))
+            {
+                CMD_PRINT("\r\n Baudrate %lu rejected , bit error = %d / 1000", baudrate, err);
+            }
+            CMD_PRINT("\r\n UART baudrate = %lu , actual = %lu , %s BR = %d BRF = %d BRS = %d , bit error = %d / 1000",
+                    baud->Baudrate, baud->Actual, baud->Os16 ? "UCOS16" : "Low-freq", baud->Br, baud->Brf, baud->Brs,
+                    baud->ErrMax);
+        }
+        else if (!memcmp(cmd, "i2c", 3))
+        {
+            tI2cMaster_Stat *stat = I2cMaster_getStat();
+            CMD_PRINT("\r\n I2C master done = %d , nack = %d , timeout = %d , arbitration lost = %d , recover = %d",
+                    stat->Done, stat->Nack, stat->Timeout, stat->ArbLost, stat->Recover);
+            CMD_PRINT("\r\n I2C master queue = %d , max used = %d , full = %d , SCL = %lu Hz", I2C_M_QUEUE_SIZE,
+                    stat->MaxQueue, stat->QueueFull, I2cMaster_getClk());
+
+            //Slave throughput since last "i2c" command.
+            tI2cSlave_Stat *sstat = I2cSlave_getStat();
+            uint32_t now = Clock_getTick();
+            uint32_t ms = CLOCK_TICK_TO_US(now - Cmd_I2cTick) / 1000;
+            CMD_PRINT("\r\n I2C slave transfer = %u , rx = %lu byte , tx = %lu byte , by DMA = %lu byte",
+                    sstat->Transfer, sstat->RxByte, sstat->TxByte, sstat->DmaByte);
+            if (ms)
+            {
+                CMD_PRINT("\r\n I2C slave rx = %lu byte/s , tx = %lu byte/s in last %lu ms",
+                        (uint32_t) ((uint64_t) (sstat->RxByte - Cmd_I2cRx) * 1000 / ms),
+                        (uint32_t) ((uint64_t) (sstat->TxByte - Cmd_I2cTx) * 1000 / ms), ms);
+            }
+            Cmd_I2cTick = now;
+            Cmd_I2cRx = sstat->RxByte;
+            Cmd_I2cTx = sstat->TxByte;
+        }
+        else if (!memcmp(cmd, "spi", 3))
+        {
+            //SPI slave input frames , period measured between CS rising edges.
+            tSpiSlave_Stat *spistat = SpiSlave_getStat();
+            uint32_t us = CLOCK_TICK_TO_US(spistat->Period);
+            CMD_PRINT("\r\n SPI slave frame = %u , drop = %u , replace = %u , full = %u , period = %lu us (%lu mHz)",
+                    spistat->Frame, spistat->Drop, spistat->Replace, spistat->Full, us,
+                    us ? 1000000000UL / us : 0UL);
+        }
+        else if (!memcmp(cmd, "uart", 4))
+        {
+            //TX ring statistics , printed before this line is queued.
+            tUart_TxStat txstat = *Uart_getTxStat();
+            CMD_PRINT("\r\n UART TX ring = %d byte , max used = %d , drop = %d byte / %d write , block = %d",
+                    UART_TX_BUF_SIZE, txstat.MaxUsed, txstat.DropByte, txstat.DropWrite, txstat.BlockCount);
+            tUart_RxStat *rxstat = Uart_getRxStat();
+            CMD_PRINT("\r\n UART RX ring = %d byte , drop = %d byte , line cut = %d , line drop = %d",
+                    UART_RX_BUF_SIZE, rxstat->DropByte, rxstat->LineCut, rxstat->LineDrop);
+            tDlog_Stat *dlogstat = Dlog_getStat();
+            CMD_PRINT("\r\n Deferred log ring = %d byte , max used = %d , log = %d , drop = %d",
+                    DLOG_BUF_SIZE, dlogstat->MaxUsed, dlogstat->Count, dlogstat->Drop);
+        }
         else
         {
             CMD_PRINT("\r\n CMD Error.");
         }
-
-        Cmd_Uart_clear();
     }
 }
@@ -13,6 +13,24 @@
 
 #include "stdint.h"
 
+/* I2C slave register map , 16bit address , auto increment , see hal_i2c.h for transfer format.
+ * Windows are read by I2C ISR straight from working data , values in MSP430 layout (little endian).
+ * Data is updated by main loop between bytes , compare CMD_I2C_DRV_STAT FrameCount before & after a read.
+ */
+#define CMD_I2C_MBOX            0x0000  //W : PLIMIT command [MainCmd][SubCmd][Param ...]  R : Response of GET command.
+#define CMD_I2C_PLIMIT_DUTY     0x1000  //R : tPlimit_Data.Duty      , HI_U16 x PLIMIT_CH_MAX.
+#define CMD_I2C_PLIMIT_LIMIT    0x1100  //R : tPlimit_Data.Limit     , HI_U16 x PLIMIT_CH_MAX.
+#define CMD_I2C_PLIMIT_TEMP     0x1200  //R : tPlimit_Data.TempDelta , HI_U32 x PLIMIT_CH_MAX.
+#define CMD_I2C_PLIMIT_SAFE     0x1400  //R : tPlimit_Data.TempSafe  , HI_U8 x PLIMIT_CH_MAX.
+#define CMD_I2C_PLIMIT_PARAM    0x1800  //R : tPlimit_Param.
+#define CMD_I2C_IN_STAT         0x2000  //R : tPlayer_InStat.
+#define CMD_I2C_DRV_STAT        0x2100  //R : tPlayer_DrvStatus.
+#define CMD_I2C_IW_STAT         0x2200  //R : tIw7027_Status.
+
+/*!@brief   Map I2C slave register windows , call once after APP_PLIMIT_init().
+ */
+extern void App_Cmd_init(void);
+
 /*!@brief   Get Command from I2C Slave & process.
  */
 extern void App_Cmd_I2c(void);
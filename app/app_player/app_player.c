@@ -22,22 +22,21 @@
  * Operation define.
  *****************************************************************************/
 #define PLAYER_SPI_S_MAX_SIZE       256
-#define PLAYER_SPI_M_CS_SEL         0x01
-#define PLAYER_SPI_M_CS_DATA_DELAY  100
-#define PLAYER_SPI_M_DATA_CS_DELAY  100
-
-#define PLAYER_DUTY_CH_MAX          128
 
 /******************************************************************************
  * Internal Variables.
  *****************************************************************************/
+uint16_t gPlayer_InDutyBuf[PLAYER_DUTY_CH_MAX];     //Input duty buffer , used when input grid is resampled.
 uint16_t gPlayer_LdDutyBuf[PLAYER_DUTY_CH_MAX];     //Local Dimming duty buffer.
 uint16_t gPlayer_TpDutyBuf[PLAYER_DUTY_CH_MAX];     //Test Pattern duty buffer.
+uint16_t gPlayer_OutDutyBuf[PLAYER_DUTY_CH_MAX];    //Output duty buffer , frame rate converted from gPlayer_LdDutyBuf.
+static uint16_t Player_OutSize = 0;                 //Zone amount of output grid.
 
 /******************************************************************************
  * Internal Functions.
  *****************************************************************************/
-#define PLAYER_LOG                  printf
+#define PLAYER_LOG                  DLOG
+#define PLAYER_PRINT                printf          //Bulk dump , printed at once.
 #define PLAYER_DELAYUS              DELAY_US
 
 uint16_t Player_D8P8_TO_D12P16(uint8_t* pu8in, uint16_t *pu16out, uint16_t in_size)
@@ -83,84 +82,60 @@ uint16_t Player_D12P8X2_TO_D12P16(uint8_t* pu8in, uint16_t *pu16out, uint16_t in
     return i;
 }
 
-uint16_t Player_D12P16_TO_D8P8(uint16_t *pu16in, uint8_t* pu8out, uint16_t in_size)
+uint16_t Player_SpiSlave_gets(uint8_t* s)
 {
-    uint16_t i;
-    for (i = 0; i < in_size; i++)
-    {
-        // 0x0ABC -> 0xAB
-        pu8out[i] = pu16in[i] >> 4;
-    }
-
-    return i;
+    //Frames are ended & buffered by CS edge ISR , no reset between frames.
+    return SpiSlave_gets(s);
 }
 
-uint16_t Player_D12P16_TO_D8P8X1_5(uint16_t *pu16in, uint8_t* pu8out, uint16_t in_size)
+/*!@brief   Get zone grid of input model , models without fixed grid use param->pin_col & pin_row.*/
+void Player_getInputGrid(PLAYER_PARAM *param, uint8_t *col, uint8_t *row)
 {
-    uint16_t i;
-    uint16_t j = 0;
-    for (i = 0; i < in_size; i++)
+    switch (param->pin_model)
     {
-        // 0x0ABC 0x0DEF -> 0xAB, 0xCD, 0xEF
-        pu8out[j++] = pu16in[i] >> 4;
-        pu8out[j++] = ((pu16in[i] & 0x0F) << 4) + ((pu16in[i + 1] & 0x0F00) >> 8);
-        pu8out[j++] = (pu16in[i + 1]) & 0xFF;
-    }
-
-    return j;
-}
-
-uint16_t Player_D12P16_TO_D8P8X2(uint16_t *pu16in, uint8_t* pu8out, uint16_t in_size)
-{
-    uint16_t i;
-    uint16_t j = 0;
-    for (i = 0; i < in_size; i++)
-    {
-        // 0x0ABC -> 0x0A , 0xBC
-        pu8out[j++] = (pu16in[i] & 0x0F00) >> 8;
-        pu8out[j++] = (pu16in[i]) & 0xFF;
+    case IN_MFC11_SU860A_6X10:
+        *col = 6;
+        *row = 10;
+        break;
+    case IN_MFC11_SU860A_6X13:
+        *col = 6;
+        *row = 13;
+        break;
+    default:
+        *col = param->pin_col ? param->pin_col : param->pch_amount;
+        *row = param->pin_row ? param->pin_row : 1;
+        break;
     }
-
-    return j;
 }
 
-uint16_t Player_SpiSlave_gets(uint8_t* s)
+/*!@brief   Get zone grid of output model , models without fixed grid use param->pout_col & pout_row.*/
+void Player_getOutputGrid(PLAYER_PARAM *param, uint8_t *col, uint8_t *row)
 {
-    uint16_t size = 0;
-    size = SpiSlave_gets(s);
-    if (size)
+    switch (param->pout_model)
     {
-        SpiSlave_clear();
+    case OUT_IW7027_GOA_16X1:
+        *col = 16;
+        *row = 1;
+        break;
+    case OUT_IW7027_SU860A_6X10:
+    case OUT_CPLD_SU860A_6X10:
+        *col = 6;
+        *row = 10;
+        break;
+    case OUT_IW7027_SU860A_6X13:
+    case OUT_CPLD_SU860A_6X13:
+        *col = 6;
+        *row = 13;
+        break;
+    case OUT_IW7037_16X4:
+        *col = 16;
+        *row = 4;
+        break;
+    default:
+        *col = param->pout_col ? param->pout_col : param->pch_amount;
+        *row = param->pout_row ? param->pout_row : 1;
+        break;
     }
-    return size;
-}
-
-void Player_SpiMaster_puts(uint8_t* s, uint16_t len)
-{
-    SpiMaster_setCsPins(PLAYER_SPI_M_CS_SEL);
-    PLAYER_DELAYUS(PLAYER_SPI_M_CS_DATA_DELAY);
-    SpiMaster_puts(s, len);
-    PLAYER_DELAYUS(PLAYER_SPI_M_DATA_CS_DELAY);
-    SpiMaster_setCsPins(0);
-}
-
-void Player_Cpld_setDuty(uint16_t *pu16duty, uint16_t duty_size, PLAYER_OUTPUT_MODEL emodel)
-{
-    //Add 1 12bit tail to the end of duty.
-    pu16duty[duty_size] = 0xDD0;
-
-    // Convert Data to Duty = 12bit , package = 8bit X 1.5 .
-    uint8_t spi_buf[PLAYER_SPI_S_MAX_SIZE];
-    uint16_t spi_size;
-    spi_size = Player_D12P16_TO_D8P8X1_5(pu16duty, spi_buf, duty_size + 1);
-
-    // Send Data
-    Player_SpiMaster_puts(spi_buf, spi_size);
-}
-
-void Player_Iw7027_setDuty(uint16_t *pu16duty, uint16_t duty_size, PLAYER_OUTPUT_MODEL emodel)
-{
-    Iw7027_setDuty(pu16duty, 0);
 }
 
 uint16_t Player_VsyncIn_getFreq(void)
@@ -173,14 +148,14 @@ uint16_t Player_VsyncIn_getRiseEdgeFlag(void)
     return PwmIn_getRiseEdgeFlag(1);
 }
 
-void Player_VsyncOut_setPwm(uint16_t freq, uint16_t duty)
+uint16_t Player_VsyncOut_getRiseEdgeFlag()
 {
-    PwmOut_setOutput(2, freq, duty);
+    return PwmOut_getRiseEdgeFlag(2);
 }
 
-uint16_t Player_VsyncOut_getRiseEdgeFlag()
+uint16_t Player_Internal_getTickFlag(void)
 {
-    return PwmOut_getRiseEdgeFlag(2);
+    return PwmOut_getRiseEdgeFlag(0);
 }
 
 /******************************************************************************
@@ -201,6 +176,7 @@ uint16_t App_Player_getDuty(uint16_t *pu16duty, PLAYER_INPUT_MODEL emodel)
     uint16_t spi_size = 0;
     uint16_t duty_size = 0;
     uint8_t spi_buf[PLAYER_SPI_S_MAX_SIZE];
+    uint8_t *payload;
 
     //Get data from SPI Slave.
     spi_size = Player_SpiSlave_gets(spi_buf);
@@ -209,38 +185,45 @@ uint16_t App_Player_getDuty(uint16_t *pu16duty, PLAYER_INPUT_MODEL emodel)
         return 0;
     }
 
+    //Validate frame , partial / merged / corrupted frames are dropped before decoding.
+    payload = App_Player_Input_check(spi_buf, &spi_size, &emodel);
+    if (payload == 0)
+    {
+        return 0;
+    }
+
     //Handle format convert.
     switch (emodel)
     {
     case IN_D8_P8:
     {
-        duty_size = Player_D8P8_TO_D12P16(spi_buf, pu16duty, spi_size);
+        duty_size = Player_D8P8_TO_D12P16(payload, pu16duty, spi_size);
         break;
     }
     case IN_D12_P8X1_5:
     {
-        duty_size = Player_D12P8X1_5_TO_D12P16(spi_buf, pu16duty, spi_size);
+        duty_size = Player_D12P8X1_5_TO_D12P16(payload, pu16duty, spi_size);
         break;
     }
     case IN_D12_P8X2:
     {
-        duty_size = Player_D12P8X2_TO_D12P16(spi_buf, pu16duty, spi_size);
+        duty_size = Player_D12P8X2_TO_D12P16(payload, pu16duty, spi_size);
         break;
     }
     case IN_MFC11_SU860A_6X10:
     {
         /* YZF : D0 + D1 + ... + DN + TAIL. Data = 12bit.
-         *       Don't know the exact format of TAIL , but it seems not cared...
-         *       Just ignore the TAIL , get fixed amount of duty according to model index.
+         *       Don't know the exact format of TAIL , length is checked with maximum tail allowed.
+         *       Only decode the duty part , get fixed amount of duty according to model index.
          */
         duty_size = 60;
-        Player_D12P8X1_5_TO_D12P16(spi_buf, pu16duty, spi_size);
+        Player_D12P8X1_5_TO_D12P16(payload, pu16duty, duty_size * 3 / 2);
         break;
     }
     case IN_MFC11_SU860A_6X13:
     {
         duty_size = 78;
-        Player_D12P8X1_5_TO_D12P16(spi_buf, pu16duty, spi_size);
+        Player_D12P8X1_5_TO_D12P16(payload, pu16duty, duty_size * 3 / 2);
         break;
     }
     default:
@@ -265,50 +248,13 @@ PLAYER_RET App_Player_setDuty(uint16_t *pu16duty, uint16_t duty_size, PLAYER_OUT
         return PLAYER_FAIL;
     }
 
-    switch (emodel)
-    {
-    case OUT_D8_P8:
-    {
-        uint8_t spi_buf[PLAYER_SPI_S_MAX_SIZE];                 //SPI Master sending buffer.
-        Player_D12P16_TO_D8P8(pu16duty, spi_buf, duty_size);    //Convert data format.
-        Player_SpiMaster_puts(spi_buf, duty_size);              //SPI out.
-
-        break;
-    }
-    case OUT_D12_P8X1_5:
-    {
-        uint8_t spi_buf[PLAYER_SPI_S_MAX_SIZE];                     //SPI Master sending buffer.
-        Player_D12P16_TO_D8P8X1_5(pu16duty, spi_buf, duty_size);    //Convert data format.
-        Player_SpiMaster_puts(spi_buf, duty_size * 3 / 2);          //SPI out.
-        break;
-    }
-    case OUT_D12_P8X2:
-    {
-        uint8_t spi_buf[PLAYER_SPI_S_MAX_SIZE];                 //SPI Master sending buffer.
-        Player_D12P16_TO_D8P8X2(pu16duty, spi_buf, duty_size);  //Convert data format.
-        Player_SpiMaster_puts(spi_buf, duty_size * 2);          //SPI out.
-        break;
-    }
-    case OUT_IW7027_GOA_16X1:
-    case OUT_IW7027_SU860A_6X10:
-    case OUT_IW7027_SU860A_6X13:
+    //Driver follows output model , all backends are served by the same path.
+    if ((emodel != App_Player_Drv_getModel()) && (App_Player_Drv_setModel(emodel) == PLAYER_FAIL))
     {
-        Player_Iw7027_setDuty(pu16duty, duty_size, emodel);     //Hand over SPI Master to BSP
-        break;
-    }
-    case OUT_CPLD_SU860A_6X10:
-    case OUT_CPLD_SU860A_6X13:
-    {
-        Player_Cpld_setDuty(pu16duty, duty_size, emodel);       //Hand over SPI Master to BSP
-        break;
-    }
-    default:
-    {
-        PLAYER_LOG("\r\nFUNC:[%s] ERROR : emodel = %x , not supported format.", __FUNCTION__, emodel);
         return PLAYER_FAIL;
     }
-    }
-    return PLAYER_SUCCESS;
+
+    return App_Player_Drv_setDuty(pu16duty, duty_size);
 }
 
 PLAYER_RET App_Player_prepareTestPattern(uint16_t *pu16tpbuf, uint16_t duty_size, PLAYER_TEST_PATTERN eptp)
@@ -388,34 +334,88 @@ PLAYER_RET App_Player_printDuty(uint16_t *pu16duty, uint16_t col, uint16_t row)
         pu16duty = gPlayer_LdDutyBuf;
     }
 
-    PLAYER_LOG("\r\nPrint Duty , COL = [%d] , ROW = [%d].\r\n", col, row);
+    PLAYER_PRINT("\r\nPrint Duty , COL = [%d] , ROW = [%d].\r\n", col, row);
 
     uint16_t i;
     for (i = 0; i < col * row; i++)
     {
         if (i % col == 0)
         {
-            PLAYER_LOG("\r\n");
+            PLAYER_PRINT("\r\n");
         }
-        PLAYER_LOG("\t%x ", pu16duty[i]);
+        PLAYER_PRINT("\t%x ", pu16duty[i]);
     }
-    PLAYER_LOG("\r\n");
+    PLAYER_PRINT("\r\n");
     return PLAYER_SUCCESS;
 }
 
 PLAYER_RET App_Player_setWorkParam(PLAYER_PARAM *param)
 {
-    return PLAYER_SUCCESS;
+    uint8_t in_col, in_row, out_col, out_row;
+
+    //Build resampling tables for current input & output model.
+    Player_getInputGrid(param, &in_col, &in_row);
+    Player_getOutputGrid(param, &out_col, &out_row);
+    Player_OutSize = (uint16_t) out_col * out_row;
+    if (Player_OutSize > PLAYER_DUTY_CH_MAX)
+    {
+        PLAYER_LOG("\r\nFUNC:[%s] ERROR : output grid %dx%d too large.", __FUNCTION__, out_col, out_row);
+        Player_OutSize = 0;
+        return PLAYER_FAIL;
+    }
+
+    //Reset input frame checking , zone amount is used for length check.
+    App_Player_Input_init(param->pin_model, in_col * in_row, param->pin_check);
+
+    //Select LED drivers , set devices & channel layout.
+    App_Player_Drv_setModel(param->pout_model);
+    if ((param->pout_model != OUT_DISABLE) && (param->pout_model_ext != OUT_DISABLE))
+    {
+        App_Player_Drv_addModel(param->pout_model_ext);
+    }
+
+    //Reset input loss handling.
+    App_Player_Hold_init(param->phold_ms, param->pfade_frames, param->presume_frames, param->psafe_duty);
+
+    //Reset frame rate conversion & set output clock.
+    App_Player_Frc_init(param->pfrc_mode);
+    if (param->pout_freq)
+    {
+        App_Player_Drv_setFreq(param->pout_freq);
+    }
+
+    return App_Player_Resample_init(param->presample_mode, in_col, in_row, out_col, out_row);
 }
 
 PLAYER_RET App_Player(PLAYER_PARAM *param)
 {
-    /*Step 1 : Get Duty from SPI slave .*/
+    /*Step 1 : Get Duty from SPI slave , resample to output grid when needed.*/
     uint16_t spi_duty_size;
-    spi_duty_size = App_Player_getDuty(gPlayer_LdDutyBuf, param->pin_model);
+    if (App_Player_Resample_isEnabled())
+    {
+        spi_duty_size = App_Player_getDuty(gPlayer_InDutyBuf, param->pin_model);
+        if (spi_duty_size)
+        {
+            spi_duty_size = App_Player_Resample(gPlayer_InDutyBuf, gPlayer_LdDutyBuf);
+        }
+    }
+    else
+    {
+        spi_duty_size = App_Player_getDuty(gPlayer_LdDutyBuf, param->pin_model);
+    }
 
-    /*Step 2 : Decide Duty output size according to SYNC MODE. */
+    /*Step 2 : Decide Duty output size according to SYNC MODE.
+     *         When output is synchronized to VSYNC or internal clock , output frame rate may differ from input ,
+     *         output duty is generated by frame rate conversion.
+     */
     uint16_t output_duty_size = 0;
+    uint16_t *output_duty_buf = gPlayer_LdDutyBuf;
+
+    if ((spi_duty_size) && (param->psync_mode != PSYNC_OUT_ON_SPI_IN))
+    {
+        App_Player_Frc_push(gPlayer_LdDutyBuf, spi_duty_size);
+        App_Player_Hold_feed(SpiSlave_getFrameTick());
+    }
 
     switch (param->psync_mode)
     {
@@ -429,9 +429,9 @@ PLAYER_RET App_Player(PLAYER_PARAM *param)
     }
     case PSYNC_OUT_ON_VSYNC_IN:
     {
-        if (Player_VsyncOut_getRiseEdgeFlag())
+        if (Player_VsyncIn_getRiseEdgeFlag())
         {
-            output_duty_size = param->pch_amount;
+            output_duty_size = Player_OutSize;
         }
         break;
     }
@@ -439,12 +439,16 @@ PLAYER_RET App_Player(PLAYER_PARAM *param)
     {
         if (Player_VsyncOut_getRiseEdgeFlag())
         {
-            output_duty_size = param->pch_amount;
+            output_duty_size = Player_OutSize;
         }
         break;
     }
     case PSYNC_OUT_ON_INTERNAL_60Hz:
     {
+        if (Player_Internal_getTickFlag())
+        {
+            output_duty_size = Player_OutSize;
+        }
         break;
     }
     default:
@@ -455,27 +459,40 @@ PLAYER_RET App_Player(PLAYER_PARAM *param)
     }
 
 
+    //Test pattern is sent on every sync tick , no SPI input needed.
+    if ((output_duty_size) && (param->psync_mode != PSYNC_OUT_ON_SPI_IN) && (param->ptest_pattern == PTP_DISABLE))
+    {
+        //Not output before 1st input frame received.
+        output_duty_size = App_Player_Frc_getDuty(gPlayer_OutDutyBuf) ? output_duty_size : 0;
+        output_duty_buf = gPlayer_OutDutyBuf;
+
+        //Hold last valid frame , fade to safe duty when input is lost.
+        if (output_duty_size)
+        {
+            App_Player_Hold(output_duty_buf, output_duty_size);
+        }
+    }
+
     //Step 3: Duty send out when output_duty_size != 0
     if (output_duty_size)
     {
         if (param->ptest_pattern != PTP_DISABLE)   //Test Mode
         {
-            //Prepare Test Pattern
-            App_Player_prepareTestPattern(gPlayer_TpDutyBuf, param->pch_amount, param->ptest_pattern);
-
-            APP_PLIMIT(gPlayer_TpDutyBuf,gPlayer_TpDutyBuf);
-
-            //Send Test Pattern
-            App_Player_setDuty(gPlayer_TpDutyBuf, param->pch_amount, param->pout_model);
+            //Prepare Test Pattern , sent instead of Local Dimming Duty.
+            App_Player_prepareTestPattern(gPlayer_TpDutyBuf, output_duty_size, param->ptest_pattern);
+            output_duty_buf = gPlayer_TpDutyBuf;
         }
-        else //Local Dimming Mode
-        {
-            //Send Local Dimming Duty.
 
-            APP_PLIMIT(gPlayer_LdDutyBuf,gPlayer_LdDutyBuf);
+        uint32_t tick = Clock_getTick();
+        APP_PLIMIT(output_duty_buf, output_duty_buf);
+        uint32_t tick_plimit = Clock_getTick();
+        App_Player_setDuty(output_duty_buf, output_duty_size, param->pout_model);
 
-            App_Player_setDuty(gPlayer_LdDutyBuf, param->pch_amount, param->pout_model);
-        }
+        //Telemetry of this frame.
+        App_Telem_setTiming(TELEM_TIMING_INPUT, SpiSlave_getStat()->Period);
+        App_Telem_setTiming(TELEM_TIMING_PLIMIT, tick_plimit - tick);
+        App_Telem_setTiming(TELEM_TIMING_OUTPUT, Clock_getTick() - tick_plimit);
+        App_Telem_frame();
     }
 
     return PLAYER_SUCCESS;
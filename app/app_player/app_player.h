@@ -18,6 +18,8 @@
 
 #include "stdint.h"
 
+#define PLAYER_DUTY_CH_MAX          128     //Maximum zone amount of 1 duty frame.
+
 typedef enum PLAYER_RET
 {
     PLAYER_FAIL = 0, PLAYER_SUCCESS = 1,
@@ -30,6 +32,8 @@ typedef enum PLAYER_INPUT_MODEL
     IN_D12_P8X1_5 = 0x02,           //RAW DATA 0xAA, 0xAB, 0xBB         -> 0x0AAA, 0x0BBB
     IN_D12_P8X2 = 0x03,             //RAW DATA 0x0A, 0xAA, 0x0B, 0xBB   -> 0x0AAA, 0x0BBB
 
+    IN_AUTO = 0x10,                 //Detect IN_D8_P8 / IN_D12_P8X1_5 / IN_D12_P8X2 from received frames.
+
     IN_MFC11_SU860A_6X10 = 0x20,   //SPI_S connect to MFC11, TV model = 60SU860A.
     IN_MFC11_SU860A_6X13 = 0x21,   //SPI_S connect to MFC11, TV model = 70SU860A.
     IN_BOTTOM = 0xFF
@@ -49,6 +53,8 @@ typedef enum PLAYER_OUTPUT_MODEL
     OUT_CPLD_SU860A_6X10 = 0x20,    //BL MODEL = 60SU860A , SPI_M connect to CPLD
     OUT_CPLD_SU860A_6X13 = 0x21,    //BL MODEL = 70SU860A , SPI_M connect to CPLD
 
+    OUT_IW7037_16X4 = 0x30,         //SPI_M connect to 4 IW7037 , 16bit duty , 16 zones each.
+
     OUT_BOTTOM = 0xFF
 } PLAYER_OUTPUT_MODEL;
 
@@ -68,18 +74,50 @@ typedef enum PLAYER_SYNC_MODE
     PSYNC_OUT_ON_SPI_IN = 0x00,         //Output duty when received valid SPI input data.
     PSYNC_OUT_ON_VSYNC_IN = 0x01,       //Output duty on VSYNC_IN rising edge.
     PSYNC_OUT_ON_VSYNC_OUT = 0x02,      //Output duty on VSYNC_OUT rising edge.
-    PSYNC_OUT_ON_INTERNAL_60Hz = 0x03,  //Output duty on Internal 60Hz clock tick.
+    PSYNC_OUT_ON_INTERNAL_60Hz = 0x03,  //Output duty on Internal clock tick (PWM OUT timer period , 60Hz by default).
 
     PSYNC_BOTTOM = 0xFF
 } PLAYER_SYNC_MODE;
 
+typedef enum PLAYER_RESAMPLE_MODE
+{
+    PRS_DISABLE = 0x00,             //Pass input zones to output directly.
+    PRS_BOX = 0x01,                 //Area weighted average of covered input zones.
+    PRS_BILINEAR = 0x02,            //Bilinear interpolation between input zone centers.
+    PRS_MAX_POOL = 0x03,            //Maximum of covered input zones , output is never darker than input.
+
+    PRS_BOTTOM = 0xFF
+} PLAYER_RESAMPLE_MODE;
+
+typedef enum PLAYER_FRC_MODE
+{
+    PFRC_REPEAT = 0x00,             //Repeat latest input frame until next input.
+    PFRC_LINEAR = 0x01,             //Linear interpolation between last 2 input frames.
+    PFRC_PEAK_HOLD = 0x02,          //Maximum of last 2 input frames.
+
+    PFRC_BOTTOM = 0xFF
+} PLAYER_FRC_MODE;
+
 typedef struct PLAYER_PARAM
 {
     uint16_t pch_amount;
     PLAYER_INPUT_MODEL pin_model;
     PLAYER_OUTPUT_MODEL pout_model;
+    PLAYER_OUTPUT_MODEL pout_model_ext;     //Output model driven together with pout_model , same duty. OUT_DISABLE = none.
     PLAYER_SYNC_MODE psync_mode;
     PLAYER_TEST_PATTERN ptest_pattern;
+    PLAYER_RESAMPLE_MODE presample_mode;
+    uint8_t pin_col;                //Input zone grid , only used when pin_model has no fixed grid. 0 = pch_amount x 1.
+    uint8_t pin_row;
+    uint8_t pout_col;               //Output zone grid , only used when pout_model has no fixed grid. 0 = pch_amount x 1.
+    uint8_t pout_row;
+    PLAYER_FRC_MODE pfrc_mode;      //Frame rate conversion , used when output is synchronized to VSYNC/internal clock.
+    uint16_t pout_freq;             //[Hz] VSYNC_OUT frequency , 0 = not change.
+    uint8_t pin_check;              //SPI input frame checking , PLAYER_IN_CHECK_XXX.
+    uint16_t phold_ms;              //[ms] Input loss timeout from last valid input frame , 0 = input loss handling disabled.
+    uint8_t pfade_frames;           //Output frames to fade to psafe_duty after input loss.
+    uint8_t presume_frames;         //Output frames to fade back to live duty after input returns.
+    uint16_t psafe_duty;            //12bit duty output when input is lost.
 } PLAYER_PARAM;
 
 extern uint16_t App_Player_getDuty(uint16_t *pu16duty, PLAYER_INPUT_MODEL emodel);
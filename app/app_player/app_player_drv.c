@@ -0,0 +1,633 @@
+/**@file    app_player_drv.c
+ *
+ * Local Dimming player LED driver layer.
+ * Every output model is served by 1 driver (RAW SPI / IW7027 / IW7037 / CPLD) through the same interface ,
+ * drivers of different families can be active together and get the same duty frame.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version , RAW / IW7027 / IW7037 / CPLD drivers.
+ * 20261019 | agent   | Active driver list , output buffer for each driver.
+ */
+
+#include "app_player_drv.h"
+#include "bsp.h"
+#include "hal.h"
+#include "string.h"
+
+/******************************************************************************
+ * Operation define.
+ *****************************************************************************/
+#define PLAYER_DRV_SPI_M_CS_SEL         0x01
+#define PLAYER_DRV_CS_DATA_DELAY        100         //CS setup time , counted by SPI master CS sequencer.
+#define PLAYER_DRV_DATA_CS_DELAY        100         //CS hold time , counted by SPI master CS sequencer.
+#define PLAYER_DRV_VSYNC_OUT_CH         2
+#define PLAYER_DRV_VSYNC_OUT_DUTY       128
+
+#define PLAYER_CPLD_TAIL                0x0DD0      //12bit tail after duty.
+
+#define PLAYER_IW7037_DEV_MAX           8
+#define PLAYER_IW7037_CH_PER_DEV        16
+#define PLAYER_IW7037_DUTY_REG          0x40
+#define PLAYER_IW7037_HEAD_SIZE         3
+#define PLAYER_IW7037_BYTE_PER_DEV      (PLAYER_IW7037_HEAD_SIZE + PLAYER_IW7037_CH_PER_DEV * 2)
+
+//Output buffer of each driver , 12bit duty in the widest wire format.
+#define PLAYER_RAW_BUF_SIZE             (PLAYER_DRV_CH_MAX * 2)
+#define PLAYER_CPLD_BUF_SIZE            (PLAYER_DRV_CH_MAX * 3 / 2 + 3)
+#define PLAYER_IW7037_BUF_SIZE          (PLAYER_IW7037_DEV_MAX * PLAYER_IW7037_BYTE_PER_DEV)
+
+//Device & channel layout of output model.
+typedef struct tPlayer_DrvModel
+{
+    PLAYER_OUTPUT_MODEL Model;
+    uint8_t DevAmount;              //Device amount.
+    const uint16_t *CsMap;          //CS pin of each device , NULL = device N on CS_N.
+    uint8_t ChAmount;               //Zone amount.
+    const uint8_t *SortMap;         //Channel of each zone , NULL = zone N on channel N.
+    const uint8_t *InitTable;       //Initialize table , IW7027_INIT_TABLE_SIZE bytes for each device , NULL = reset default.
+} tPlayer_DrvModel;
+
+/* Initialize tables of panel are added to the model here , passed to Iw7027_init() by the driver.
+ * No verified table of these panels yet , devices keep reset default.
+ */
+static const tPlayer_DrvModel PLAYER_IW7027_MODEL_LIST[] =
+{
+    { OUT_IW7027_GOA_16X1, 1, 0, 16, 0, 0 },
+    { OUT_IW7027_SU860A_6X10, 4, 0, 60, 0, 0 },
+    { OUT_IW7027_SU860A_6X13, 5, 0, 78, 0, 0 },
+};
+
+static const tPlayer_DrvModel PLAYER_IW7037_MODEL_LIST[] =
+{
+    { OUT_IW7037_16X4, 4, 0, 64, 0, 0 },
+};
+
+/******************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+static const tPlayer_Drv *Player_Drv[PLAYER_DRV_ACTIVE_MAX];     //Active drivers , 1 for each driver family.
+static uint16_t Player_DrvCs[PLAYER_DRV_ACTIVE_MAX];            //SPI master CS pins of each active driver.
+static uint8_t Player_DrvAmount = 0;
+static tPlayer_DrvStatus Player_DrvStatus;
+static PLAYER_OUTPUT_MODEL Player_RawModel = OUT_DISABLE;
+static const tPlayer_DrvModel *Player_Iw7027Model = 0;
+static const tPlayer_DrvModel *Player_Iw7037Model = 0;
+
+/* Packed output frame of each driver , sent by SPI master ISR after setDuty returns.
+ * Drivers active together queue their frames at the same time , buffers are not shared.
+ */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(Player_RawBuf, 2)
+#pragma DATA_ALIGN(Player_CpldBuf, 2)
+#pragma DATA_ALIGN(Player_Iw7037Buf, 2)
+#endif
+static uint8_t Player_RawBuf[PLAYER_RAW_BUF_SIZE];
+static uint8_t Player_CpldBuf[PLAYER_CPLD_BUF_SIZE];
+static uint8_t Player_Iw7037Buf[PLAYER_IW7037_BUF_SIZE];
+
+/******************************************************************************
+ * Internal Functions.
+ *****************************************************************************/
+#define PLAYER_DRV_LOG              DLOG
+
+/*!@brief   Find model descriptor in list.*/
+const tPlayer_DrvModel *Player_Drv_findModel(const tPlayer_DrvModel *list, uint8_t amount, PLAYER_OUTPUT_MODEL emodel)
+{
+    uint8_t i;
+    for (i = 0; i < amount; i++)
+    {
+        if (list[i].Model == emodel)
+        {
+            return &list[i];
+        }
+    }
+    return 0;
+}
+
+/*!@brief   SPI master CS pins used by output model.*/
+uint16_t Player_Drv_getCs(PLAYER_OUTPUT_MODEL emodel)
+{
+    const tPlayer_DrvModel *model = Player_Drv_findModel(PLAYER_IW7027_MODEL_LIST,
+            sizeof(PLAYER_IW7027_MODEL_LIST) / sizeof(PLAYER_IW7027_MODEL_LIST[0]), emodel);
+    uint16_t cs = 0;
+    uint8_t dev;
+
+    if (model == 0)
+    {
+        model = Player_Drv_findModel(PLAYER_IW7037_MODEL_LIST,
+                sizeof(PLAYER_IW7037_MODEL_LIST) / sizeof(PLAYER_IW7037_MODEL_LIST[0]), emodel);
+    }
+    //RAW / CPLD : 1 CS window for whole frame.
+    if (model == 0)
+    {
+        return PLAYER_DRV_SPI_M_CS_SEL;
+    }
+    for (dev = 0; dev < model->DevAmount; dev++)
+    {
+        cs |= model->CsMap ? model->CsMap[dev] : (1 << dev);
+    }
+    return cs;
+}
+
+/*!@brief   Queue 1 CS window , returns before sent. Buffer is not copied.*/
+void Player_Drv_spiPuts(uint16_t cs, uint8_t *s, uint16_t len)
+{
+    SpiMaster_putsAsync(cs, 0, 0, s, len);
+}
+
+/*!@brief   0x0ABC -> 0xAB */
+uint16_t Player_Drv_packD8(const uint16_t *in, uint8_t *out, uint16_t n)
+{
+    const uint16_t *end = in + n;
+    while (in < end)
+    {
+        *out++ = *in++ >> 4;
+    }
+    return n;
+}
+
+/*!@brief   0x0ABC , 0x0DEF -> 0xAB , 0xCD , 0xEF
+ *          Odd amount : last duty takes 2 bytes , low half of 2nd byte = 0.
+ */
+uint16_t Player_Drv_packD12X1_5(const uint16_t *in, uint8_t *out, uint16_t n)
+{
+    const uint16_t *end = in + (n & ~1);
+    uint8_t *start = out;
+
+    while (in < end)
+    {
+        uint16_t a = *in++;
+        uint16_t b = *in++;
+        *out++ = a >> 4;
+        *out++ = (a << 4) | (b >> 8);
+        *out++ = b;
+    }
+    if (n & 1)
+    {
+        *out++ = *in >> 4;
+        *out++ = *in << 4;
+    }
+    return out - start;
+}
+
+/*!@brief   0x0ABC -> 0x0A , 0xBC */
+uint16_t Player_Drv_packD12X2(const uint16_t *in, uint8_t *out, uint16_t n)
+{
+    const uint16_t *end = in + n;
+    while (in < end)
+    {
+        uint16_t v = *in++;
+        *out++ = v >> 8;
+        *out++ = v;
+    }
+    return n * 2;
+}
+
+/*!@brief   12bit -> 16bit full scale , 0x0ABC -> 0xAB , 0xCA */
+uint16_t Player_Drv_packD16(const uint16_t *in, uint8_t *out, uint16_t n)
+{
+    const uint16_t *end = in + n;
+    while (in < end)
+    {
+        uint16_t v = *in++;
+        v = (v << 4) | (v >> 8);
+        *out++ = v >> 8;
+        *out++ = v;
+    }
+    return n * 2;
+}
+
+/*****************************************************************************
+ * [ RAW SPI ] Driver , duty to SPI master directly.
+ *****************************************************************************/
+PLAYER_RET Player_Raw_setModel(PLAYER_OUTPUT_MODEL emodel)
+{
+    Player_RawModel = emodel;
+    SpiMaster_setCsTiming(PLAYER_DRV_SPI_M_CS_SEL, PLAYER_DRV_CS_DATA_DELAY, PLAYER_DRV_DATA_CS_DELAY);
+    return PLAYER_SUCCESS;
+}
+
+PLAYER_RET Player_Raw_setDuty(uint16_t *pu16duty, uint16_t duty_size)
+{
+    uint16_t size;
+
+    switch (Player_RawModel)
+    {
+    case OUT_D8_P8:
+        size = Player_Drv_packD8(pu16duty, Player_RawBuf, duty_size);
+        break;
+    case OUT_D12_P8X1_5:
+        size = Player_Drv_packD12X1_5(pu16duty, Player_RawBuf, duty_size);
+        break;
+    case OUT_D12_P8X2:
+        size = Player_Drv_packD12X2(pu16duty, Player_RawBuf, duty_size);
+        break;
+    default:
+        return PLAYER_FAIL;
+    }
+
+    Player_Drv_spiPuts(PLAYER_DRV_SPI_M_CS_SEL, Player_RawBuf, size);
+    Player_DrvStatus.ByteCount += size;
+    return PLAYER_SUCCESS;
+}
+
+static const tPlayer_Drv PLAYER_DRV_RAW =
+{
+    0, Player_Raw_setModel, Player_Raw_setDuty, 0, 0, 0
+};
+
+/*****************************************************************************
+ * [ CPLD ] Driver , 12bit duty + 12bit tail , package = 8bit X 1.5 .
+ *****************************************************************************/
+PLAYER_RET Player_Cpld_setModel(PLAYER_OUTPUT_MODEL emodel)
+{
+    SpiMaster_setCsTiming(PLAYER_DRV_SPI_M_CS_SEL, PLAYER_DRV_CS_DATA_DELAY, PLAYER_DRV_DATA_CS_DELAY);
+    return PLAYER_SUCCESS;
+}
+
+PLAYER_RET Player_Cpld_setDuty(uint16_t *pu16duty, uint16_t duty_size)
+{
+    //Pack duty pairs , the tail pairs with the last odd duty or starts a new pair.
+    uint16_t size = Player_Drv_packD12X1_5(pu16duty, Player_CpldBuf, duty_size & ~1);
+    uint8_t *out = &Player_CpldBuf[size];
+
+    if (duty_size & 1)
+    {
+        uint16_t a = pu16duty[duty_size - 1];
+        *out++ = a >> 4;
+        *out++ = (a << 4) | (PLAYER_CPLD_TAIL >> 8);
+        *out++ = PLAYER_CPLD_TAIL & 0xFF;
+        size += 3;
+    }
+    else
+    {
+        *out++ = PLAYER_CPLD_TAIL >> 4;
+        *out++ = PLAYER_CPLD_TAIL << 4;
+        size += 2;
+    }
+
+    Player_Drv_spiPuts(PLAYER_DRV_SPI_M_CS_SEL, Player_CpldBuf, size);
+    Player_DrvStatus.ByteCount += size;
+    return PLAYER_SUCCESS;
+}
+
+static const tPlayer_Drv PLAYER_DRV_CPLD =
+{
+    0, Player_Cpld_setModel, Player_Cpld_setDuty, 0, 0, 0
+};
+
+/*****************************************************************************
+ * [ IW7027 ] Driver , hand over SPI master to BSP , CS timing set by Iw7027_setDevice().
+ *****************************************************************************/
+PLAYER_RET Player_Iw7027_init(uint8_t bon)
+{
+    //Table of current model , read only by BSP.
+    uint8_t *table = Player_Iw7027Model ? (uint8_t *) Player_Iw7027Model->InitTable : 0;
+    return Iw7027_init(bon, table) == IW7027_SUCCESS ? PLAYER_SUCCESS : PLAYER_FAIL;
+}
+
+PLAYER_RET Player_Iw7027_setModel(PLAYER_OUTPUT_MODEL emodel)
+{
+    const tPlayer_DrvModel *model = Player_Drv_findModel(PLAYER_IW7027_MODEL_LIST,
+            sizeof(PLAYER_IW7027_MODEL_LIST) / sizeof(PLAYER_IW7027_MODEL_LIST[0]), emodel);
+
+    if ((model == 0) || (Iw7027_setDevice(model->DevAmount, model->CsMap) == IW7027_FAIL)
+            || (Iw7027_setLayout(model->SortMap, model->ChAmount) == IW7027_FAIL))
+    {
+        return PLAYER_FAIL;
+    }
+    Player_Iw7027Model = model;
+    return PLAYER_SUCCESS;
+}
+
+PLAYER_RET Player_Iw7027_setDuty(uint16_t *pu16duty, uint16_t duty_size)
+{
+    //Duty is packed by BSP with channel layout , unchanged devices are skipped.
+    IW7027_RET ret = Iw7027_setDuty(pu16duty);
+
+    //Register access of configuration is serviced after duty sent , bounded per frame.
+    Iw7027_serviceQueue(IW7027_QUEUE_OPS_PER_FRAME);
+
+    Player_DrvStatus.ByteCount += Iw7027_getDutyStat()->DevSent * IW7027_DUTY_BYTE_PER_DEV;
+    return ret == IW7027_SUCCESS ? PLAYER_SUCCESS : PLAYER_FAIL;
+}
+
+PLAYER_RET Player_Iw7027_setCurrent(uint8_t current)
+{
+    return Iw7027_setCurrent(current) == IW7027_SUCCESS ? PLAYER_SUCCESS : PLAYER_FAIL;
+}
+
+PLAYER_RET Player_Iw7027_setFreq(uint16_t freq)
+{
+    //BSP takes 8bit frequency , out of range value must not be truncated to a supported one (306 -> 50).
+    if (freq > 0xFF)
+    {
+        PLAYER_DRV_LOG("\r\nFUNC:[%s] ERROR : freq = %d , not supported.", __FUNCTION__, freq);
+        return PLAYER_FAIL;
+    }
+    return Iw7027_setFreq((uint8_t) freq, 1) == IW7027_SUCCESS ? PLAYER_SUCCESS : PLAYER_FAIL;
+}
+
+/*!@brief   Devices failed chip ID check at init , or not in normal state at last monitor scan.*/
+uint16_t Player_Iw7027_getFault(void)
+{
+    return Iw7027_getInitStat()->IdFail | Iw7027_getStatus()->Fault;
+}
+
+static const tPlayer_Drv PLAYER_DRV_IW7027 =
+{
+    Player_Iw7027_init, Player_Iw7027_setModel, Player_Iw7027_setDuty, Player_Iw7027_setCurrent,
+    Player_Iw7027_setFreq, Player_Iw7027_getFault
+};
+
+/*****************************************************************************
+ * [ IW7037 ] Driver , 16bit duty , 1 burst of 16 channels for each device.
+ *****************************************************************************/
+PLAYER_RET Player_Iw7037_setModel(PLAYER_OUTPUT_MODEL emodel)
+{
+    Player_Iw7037Model = Player_Drv_findModel(PLAYER_IW7037_MODEL_LIST,
+            sizeof(PLAYER_IW7037_MODEL_LIST) / sizeof(PLAYER_IW7037_MODEL_LIST[0]), emodel);
+
+    if ((Player_Iw7037Model == 0) || (Player_Iw7037Model->DevAmount > PLAYER_IW7037_DEV_MAX))
+    {
+        Player_Iw7037Model = 0;
+        return PLAYER_FAIL;
+    }
+
+    uint8_t dev;
+    for (dev = 0; dev < Player_Iw7037Model->DevAmount; dev++)
+    {
+        SpiMaster_setCsTiming(Player_Iw7037Model->CsMap ? Player_Iw7037Model->CsMap[dev] : (1 << dev),
+                PLAYER_DRV_CS_DATA_DELAY, PLAYER_DRV_DATA_CS_DELAY);
+    }
+    return PLAYER_SUCCESS;
+}
+
+PLAYER_RET Player_Iw7037_setDuty(uint16_t *pu16duty, uint16_t duty_size)
+{
+    const tPlayer_DrvModel *model = Player_Iw7037Model;
+    uint16_t ch[PLAYER_IW7037_CH_PER_DEV];
+    uint8_t dev, i;
+
+    if (model == 0)
+    {
+        return PLAYER_FAIL;
+    }
+
+    for (dev = 0; dev < model->DevAmount; dev++)
+    {
+        uint8_t *frame = &Player_Iw7037Buf[PLAYER_IW7037_BYTE_PER_DEV * dev];
+        uint16_t first = dev * PLAYER_IW7037_CH_PER_DEV;
+        uint16_t *src = &pu16duty[first];
+
+        //Gather zones when sorted or partly out of frame , zones out of frame are off.
+        if (model->SortMap || (first + PLAYER_IW7037_CH_PER_DEV > duty_size))
+        {
+            for (i = 0; i < PLAYER_IW7037_CH_PER_DEV; i++)
+            {
+                uint16_t zone = model->SortMap ? model->SortMap[first + i] : first + i;
+                ch[i] = zone < duty_size ? pu16duty[zone] : 0;
+            }
+            src = ch;
+        }
+
+        frame[0] = 0x01;
+        frame[1] = PLAYER_IW7037_CH_PER_DEV * 2;
+        frame[2] = PLAYER_IW7037_DUTY_REG;
+        Player_Drv_packD16(src, &frame[PLAYER_IW7037_HEAD_SIZE], PLAYER_IW7037_CH_PER_DEV);
+        Player_Drv_spiPuts(model->CsMap ? model->CsMap[dev] : (1 << dev), frame, PLAYER_IW7037_BYTE_PER_DEV);
+    }
+
+    Player_DrvStatus.ByteCount += PLAYER_IW7037_BYTE_PER_DEV * model->DevAmount;
+    return PLAYER_SUCCESS;
+}
+
+static const tPlayer_Drv PLAYER_DRV_IW7037 =
+{
+    0, Player_Iw7037_setModel, Player_Iw7037_setDuty, 0, 0, 0
+};
+
+/*!@brief   Get driver of output model.*/
+const tPlayer_Drv *Player_Drv_find(PLAYER_OUTPUT_MODEL emodel)
+{
+    switch (emodel)
+    {
+    case OUT_D8_P8:
+    case OUT_D12_P8X1_5:
+    case OUT_D12_P8X2:
+        return &PLAYER_DRV_RAW;
+    case OUT_IW7027_GOA_16X1:
+    case OUT_IW7027_SU860A_6X10:
+    case OUT_IW7027_SU860A_6X13:
+        return &PLAYER_DRV_IW7027;
+    case OUT_IW7037_16X4:
+        return &PLAYER_DRV_IW7037;
+    case OUT_CPLD_SU860A_6X10:
+    case OUT_CPLD_SU860A_6X13:
+        return &PLAYER_DRV_CPLD;
+    default:
+        return 0;
+    }
+}
+
+/*!@brief   Add driver of output model to active list , replaces the model of an active driver of same family.*/
+PLAYER_RET Player_Drv_add(PLAYER_OUTPUT_MODEL emodel)
+{
+    const tPlayer_Drv *drv = Player_Drv_find(emodel);
+    uint16_t cs = Player_Drv_getCs(emodel);
+    uint8_t i, j;
+
+    if (drv == 0)
+    {
+        PLAYER_DRV_LOG("\r\nFUNC:[%s] ERROR : emodel = %x , no driver.", __FUNCTION__, emodel);
+        return PLAYER_FAIL;
+    }
+
+    for (i = 0; (i < Player_DrvAmount) && (Player_Drv[i] != drv); i++)
+    {
+        ;
+    }
+    if (i >= PLAYER_DRV_ACTIVE_MAX)
+    {
+        PLAYER_DRV_LOG("\r\nFUNC:[%s] ERROR : emodel = %x , too many drivers.", __FUNCTION__, emodel);
+        return PLAYER_FAIL;
+    }
+
+    //Drivers active together must not share CS pins , CS timing is set by each driver.
+    for (j = 0; j < Player_DrvAmount; j++)
+    {
+        if ((j != i) && (Player_DrvCs[j] & cs))
+        {
+            PLAYER_DRV_LOG("\r\nFUNC:[%s] ERROR : emodel = %x , CS %x used by other driver.", __FUNCTION__, emodel,
+                    Player_DrvCs[j] & cs);
+            return PLAYER_FAIL;
+        }
+    }
+
+    if (drv->SetModel && (drv->SetModel(emodel) == PLAYER_FAIL))
+    {
+        PLAYER_DRV_LOG("\r\nFUNC:[%s] ERROR : emodel = %x , device setting fail.", __FUNCTION__, emodel);
+        return PLAYER_FAIL;
+    }
+
+    Player_Drv[i] = drv;
+    Player_DrvCs[i] = cs;
+    if (i == 0)
+    {
+        Player_DrvStatus.Model = emodel;
+    }
+    if (i == Player_DrvAmount)
+    {
+        Player_DrvAmount++;
+    }
+    return PLAYER_SUCCESS;
+}
+
+/******************************************************************************
+ * External Functions.
+ *****************************************************************************/
+PLAYER_RET App_Player_Drv_setModel(PLAYER_OUTPUT_MODEL emodel)
+{
+    memset(&Player_DrvStatus, 0x00, sizeof(Player_DrvStatus));
+    Player_DrvAmount = 0;
+
+    if (emodel == OUT_DISABLE)
+    {
+        return PLAYER_SUCCESS;
+    }
+    return Player_Drv_add(emodel);
+}
+
+PLAYER_RET App_Player_Drv_addModel(PLAYER_OUTPUT_MODEL emodel)
+{
+    if (Player_DrvAmount == 0)
+    {
+        return App_Player_Drv_setModel(emodel);
+    }
+    return Player_Drv_add(emodel);
+}
+
+PLAYER_RET App_Player_Drv_init(uint8_t bon)
+{
+    PLAYER_RET ret = PLAYER_SUCCESS;
+    uint8_t i;
+
+    if (Player_DrvAmount == 0)
+    {
+        return PLAYER_FAIL;
+    }
+    for (i = 0; i < Player_DrvAmount; i++)
+    {
+        if (Player_Drv[i]->Init && (Player_Drv[i]->Init(bon) == PLAYER_FAIL))
+        {
+            ret = PLAYER_FAIL;
+        }
+    }
+    return ret;
+}
+
+PLAYER_RET App_Player_Drv_setDuty(uint16_t *pu16duty, uint16_t duty_size)
+{
+    PLAYER_RET ret = PLAYER_SUCCESS;
+    uint8_t i;
+
+    if (Player_DrvAmount == 0)
+    {
+        return PLAYER_FAIL;
+    }
+    if (duty_size > PLAYER_DRV_CH_MAX)
+    {
+        duty_size = PLAYER_DRV_CH_MAX;
+    }
+
+    //Output buffers are repacked , last frame must be out.
+    SpiMaster_flush();
+    Player_DrvStatus.ByteCount = 0;
+    for (i = 0; i < Player_DrvAmount; i++)
+    {
+        if (Player_Drv[i]->SetDuty(pu16duty, duty_size) == PLAYER_FAIL)
+        {
+            ret = PLAYER_FAIL;
+        }
+    }
+
+    if (ret == PLAYER_FAIL)
+    {
+        Player_DrvStatus.FrameFail++;
+        return PLAYER_FAIL;
+    }
+    Player_DrvStatus.FrameCount++;
+    return PLAYER_SUCCESS;
+}
+
+PLAYER_RET App_Player_Drv_setCurrent(uint8_t current)
+{
+    PLAYER_RET ret = PLAYER_FAIL;
+    uint8_t i;
+
+    for (i = 0; i < Player_DrvAmount; i++)
+    {
+        if (Player_Drv[i]->SetCurrent == 0)
+        {
+            continue;
+        }
+        if (Player_Drv[i]->SetCurrent(current) == PLAYER_FAIL)
+        {
+            return PLAYER_FAIL;
+        }
+        ret = PLAYER_SUCCESS;
+    }
+    if (ret == PLAYER_FAIL)
+    {
+        PLAYER_DRV_LOG("\r\nFUNC:[%s] ERROR : emodel = %x , not supported.", __FUNCTION__, Player_DrvStatus.Model);
+    }
+    return ret;
+}
+
+PLAYER_RET App_Player_Drv_setFreq(uint16_t freq)
+{
+    PLAYER_RET ret = PLAYER_SUCCESS;
+    uint8_t vsync = (Player_DrvAmount == 0);
+    uint8_t i;
+
+    for (i = 0; i < Player_DrvAmount; i++)
+    {
+        if (Player_Drv[i]->SetFreq == 0)
+        {
+            vsync = 1;
+        }
+        else if (Player_Drv[i]->SetFreq(freq) == PLAYER_FAIL)
+        {
+            ret = PLAYER_FAIL;
+        }
+    }
+
+    //No frequency setting in some device , the frame clock of player is set for them.
+    if (vsync)
+    {
+        PwmOut_setOutputSync(PLAYER_DRV_VSYNC_OUT_CH, freq, PLAYER_DRV_VSYNC_OUT_DUTY);
+    }
+    return ret;
+}
+
+PLAYER_OUTPUT_MODEL App_Player_Drv_getModel(void)
+{
+    return Player_DrvAmount ? Player_DrvStatus.Model : OUT_DISABLE;
+}
+
+tPlayer_DrvStatus *App_Player_Drv_getStatus(void)
+{
+    uint8_t i;
+
+    Player_DrvStatus.Fault = 0;
+    for (i = 0; i < Player_DrvAmount; i++)
+    {
+        if (Player_Drv[i]->GetFault)
+        {
+            Player_DrvStatus.Fault |= Player_Drv[i]->GetFault();
+        }
+    }
+    return &Player_DrvStatus;
+}
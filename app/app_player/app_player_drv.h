@@ -0,0 +1,102 @@
+/**@file    app_player_drv.h
+ *
+ * Local Dimming player LED driver layer.
+ * Every output model is served by 1 driver (RAW SPI / IW7027 / IW7037 / CPLD) through the same interface ,
+ * the player sends duty through 1 code path whatever the backend is.
+ * Drivers of different families can be active together , every active driver gets the same duty frame.
+ *
+ * Each driver packs 12bit duty with a kernel for its own wire format into its own static output buffer ,
+ * the buffer stays valid after setDuty returns and can be handed to DMA.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version.
+ * 20261019 | agent   | Add App_Player_Drv_addModel.
+ */
+
+#ifndef APP_APP_PLAYER_DRV_H_
+#define APP_APP_PLAYER_DRV_H_
+
+#include "stdint.h"
+#include "app_player.h"
+
+#define PLAYER_DRV_CH_MAX           128     //Maximum duty amount of 1 frame.
+#define PLAYER_DRV_ACTIVE_MAX       4       //Drivers active together , 1 for each driver family.
+
+typedef struct tPlayer_DrvStatus
+{
+    PLAYER_OUTPUT_MODEL Model;  //Output model of the 1st active driver.
+    uint16_t FrameCount;        //Frames sent.
+    uint16_t FrameFail;         //Frames rejected by any active driver.
+    uint16_t ByteCount;         //SPI bytes of last frame , all active drivers.
+    uint16_t Fault;             //Faulty devices reported by active drivers , bit = device.
+} tPlayer_DrvStatus;
+
+/* LED driver interface , function not supported by the device is NULL.
+ * Init     : Hardware on / off.
+ * SetModel : Devices & channel layout of output model , no hardware access.
+ * SetDuty  : Pack & send 1 frame of 12bit duty , update ByteCount of status.
+ * SetFreq  : [Hz] Frame frequency , NULL = only VSYNC_OUT of player is set.
+ * GetFault : Faulty devices , bit = device.
+ */
+typedef struct tPlayer_Drv
+{
+    PLAYER_RET (*Init)(uint8_t bon);
+    PLAYER_RET (*SetModel)(PLAYER_OUTPUT_MODEL emodel);
+    PLAYER_RET (*SetDuty)(uint16_t *pu16duty, uint16_t duty_size);
+    PLAYER_RET (*SetCurrent)(uint8_t current);
+    PLAYER_RET (*SetFreq)(uint16_t freq);
+    uint16_t (*GetFault)(void);
+} tPlayer_Drv;
+
+/*!@fn      App_Player_Drv_setModel
+ * @brief   Select driver of output model as the only active driver & set its devices ,
+ *          call when output model changes.
+ * @param   emodel  is the output model.
+ * @return  PLAYER_SUCCESS or PLAYER_FAIL (no driver for the model).
+ */
+extern PLAYER_RET App_Player_Drv_setModel(PLAYER_OUTPUT_MODEL emodel);
+
+/*!@fn      App_Player_Drv_addModel
+ * @brief   Activate driver of 1 more output model & set its devices.
+ *          Replaces the output model when a driver of the same family is already active.
+ * @param   emodel  is the output model.
+ * @return  PLAYER_SUCCESS or PLAYER_FAIL (no driver for the model or too many drivers).
+ */
+extern PLAYER_RET App_Player_Drv_addModel(PLAYER_OUTPUT_MODEL emodel);
+
+/*!@fn      App_Player_Drv_init
+ * @brief   Turn on / off LED driver hardware of all active drivers.
+ * @param   bon     is 1 : on , 0 : off.
+ */
+extern PLAYER_RET App_Player_Drv_init(uint8_t bon);
+
+/*!@fn      App_Player_Drv_setDuty
+ * @brief   Send 1 frame of 12bit duty to all active drivers.
+ * @param   pu16duty    is the pointer to duty.
+ * @param   duty_size   is the duty amount.
+ */
+extern PLAYER_RET App_Player_Drv_setDuty(uint16_t *pu16duty, uint16_t duty_size);
+
+/*!@fn      App_Player_Drv_setCurrent
+ * @brief   Set LED current of active drivers supporting it , unit by device.
+ */
+extern PLAYER_RET App_Player_Drv_setCurrent(uint8_t current);
+
+/*!@fn      App_Player_Drv_setFreq
+ * @brief   Set frame frequency of all active drivers , unit in Hz.
+ */
+extern PLAYER_RET App_Player_Drv_setFreq(uint16_t freq);
+
+/*!@fn      App_Player_Drv_getModel
+ * @return  Output model of the 1st active driver , OUT_DISABLE = no driver.
+ */
+extern PLAYER_OUTPUT_MODEL App_Player_Drv_getModel(void);
+
+/*!@fn      App_Player_Drv_getStatus
+ * @return  Pointer to status of active drivers , fault is updated when called.
+ */
+extern tPlayer_DrvStatus *App_Player_Drv_getStatus(void);
+
+#endif /* APP_APP_PLAYER_DRV_H_ */
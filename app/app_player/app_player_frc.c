@@ -0,0 +1,142 @@
+/**@file    app_player_frc.c
+ *
+ * Local Dimming player frame rate conversion.
+ * Convert duty from SPI input frame rate (e.g. 50/60Hz) to backlight output frame rate (e.g. 120Hz).
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version , frame rate conversion.
+ */
+
+#include "app_player_frc.h"
+#include "string.h"
+
+/******************************************************************************
+ * Operation define.
+ *****************************************************************************/
+#define PLAYER_FRC_CH_MAX           128
+#define PLAYER_FRC_PERIOD_MAX       (255 << PLAYER_FRC_PERIOD_BIT)   //Input lost , stop measuring.
+
+/******************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+static PLAYER_FRC_MODE Player_FrcMode = PFRC_REPEAT;
+static uint16_t Player_FrcHist[2][PLAYER_FRC_CH_MAX];  //Frame history , [Player_FrcCur] is the latest.
+static uint8_t Player_FrcCur = 0;
+static uint8_t Player_FrcFrames = 0;                   //Valid frames in history , 0~2.
+static uint16_t Player_FrcSize = 0;
+static uint16_t Player_FrcTicks = 0;                   //Output frames since last input frame.
+static uint16_t Player_FrcPeriod = 1 << PLAYER_FRC_PERIOD_BIT;   //Average input period in output frames.
+
+/******************************************************************************
+ * External Functions.
+ *****************************************************************************/
+void App_Player_Frc_init(PLAYER_FRC_MODE mode)
+{
+    Player_FrcMode = mode;
+    Player_FrcFrames = 0;
+    Player_FrcSize = 0;
+    Player_FrcTicks = 0;
+    Player_FrcPeriod = 1 << PLAYER_FRC_PERIOD_BIT;
+}
+
+void App_Player_Frc_push(uint16_t *pu16duty, uint16_t duty_size)
+{
+    if (duty_size > PLAYER_FRC_CH_MAX)
+    {
+        duty_size = PLAYER_FRC_CH_MAX;
+    }
+
+    //Overwrite the older frame , it becomes the latest.
+    Player_FrcCur ^= 1;
+    memcpy(Player_FrcHist[Player_FrcCur], pu16duty, duty_size * sizeof(uint16_t));
+    Player_FrcSize = duty_size;
+
+    if (Player_FrcTicks < (PLAYER_FRC_PERIOD_MAX >> PLAYER_FRC_PERIOD_BIT))
+    {
+        if (Player_FrcFrames == 1)
+        {
+            //1st measurement.
+            Player_FrcPeriod = Player_FrcTicks << PLAYER_FRC_PERIOD_BIT;
+        }
+        else if (Player_FrcFrames == 2)
+        {
+            //Average input period : Period = Period * 3/4 + Ticks * 1/4
+            Player_FrcPeriod = (Player_FrcPeriod * 3 + (Player_FrcTicks << PLAYER_FRC_PERIOD_BIT) + 2) >> 2;
+        }
+    }
+    if (Player_FrcFrames < 2)
+    {
+        Player_FrcFrames++;
+    }
+    Player_FrcTicks = 0;
+}
+
+uint16_t App_Player_Frc_getDuty(uint16_t *pu16out)
+{
+    if (Player_FrcFrames == 0)
+    {
+        return 0;
+    }
+
+    uint16_t i;
+    uint16_t *cur = Player_FrcHist[Player_FrcCur];
+    uint16_t *prev = Player_FrcHist[Player_FrcCur ^ 1];
+
+    //Only 1 frame received , nothing to convert.
+    PLAYER_FRC_MODE mode = (Player_FrcFrames < 2) ? PFRC_REPEAT : Player_FrcMode;
+
+    switch (mode)
+    {
+    case PFRC_LINEAR:
+    {
+        /* Output = Prev + (Cur - Prev) * Phase , Phase = Ticks / Period.
+         * Output reaches Cur 1 input frame later , so the motion is continuous.
+         */
+        uint32_t phase = ((uint32_t) Player_FrcTicks << (PLAYER_FRC_PHASE_BIT + PLAYER_FRC_PERIOD_BIT))
+                / (Player_FrcPeriod ? Player_FrcPeriod : 1);
+        if (phase >= (1 << PLAYER_FRC_PHASE_BIT))
+        {
+            memcpy(pu16out, cur, Player_FrcSize * sizeof(uint16_t));
+        }
+        else
+        {
+            for (i = 0; i < Player_FrcSize; i++)
+            {
+                pu16out[i] = prev[i]
+                        + (int16_t) (((int32_t) ((int16_t) cur[i] - (int16_t) prev[i]) * (int16_t) phase)
+                                >> PLAYER_FRC_PHASE_BIT);
+            }
+        }
+        break;
+    }
+    case PFRC_PEAK_HOLD:
+    {
+        //Output the brighter of last 2 frames , never undershoot during transition.
+        for (i = 0; i < Player_FrcSize; i++)
+        {
+            pu16out[i] = cur[i] > prev[i] ? cur[i] : prev[i];
+        }
+        break;
+    }
+    case PFRC_REPEAT:
+    default:
+    {
+        memcpy(pu16out, cur, Player_FrcSize * sizeof(uint16_t));
+        break;
+    }
+    }
+
+    if (Player_FrcTicks < 0xFFFF)
+    {
+        Player_FrcTicks++;
+    }
+
+    return Player_FrcSize;
+}
+
+uint16_t App_Player_Frc_getInputPeriod(void)
+{
+    return Player_FrcPeriod;
+}
@@ -0,0 +1,49 @@
+/**@file    app_player_frc.h
+ *
+ * Local Dimming player frame rate conversion.
+ * Convert duty from SPI input frame rate (e.g. 50/60Hz) to backlight output frame rate (e.g. 120Hz).
+ *
+ * A 2 frame history is kept , output frames are generated on every output clock tick
+ * (VSYNC_OUT or internal clock) by repeat , linear interpolation or peak hold.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version.
+ */
+
+#ifndef APP_APP_PLAYER_FRC_H_
+#define APP_APP_PLAYER_FRC_H_
+
+#include "stdint.h"
+#include "app_player.h"
+
+#define PLAYER_FRC_PHASE_BIT        8           //Interpolation phase resolution , 1.0 = 256.
+#define PLAYER_FRC_PERIOD_BIT       4           //Input period resolution , unit in 1/16 output frame.
+
+/*!@fn      App_Player_Frc_init
+ * @brief   Reset frame history & set conversion mode.
+ * @param   mode    is the frame rate conversion mode.
+ */
+extern void App_Player_Frc_init(PLAYER_FRC_MODE mode);
+
+/*!@fn      App_Player_Frc_push
+ * @brief   Push 1 new input frame into history , call when valid SPI input is received.
+ * @param   pu16duty    is the pointer to input duty.
+ * @param   duty_size   is the duty amount.
+ */
+extern void App_Player_Frc_push(uint16_t *pu16duty, uint16_t duty_size);
+
+/*!@fn      App_Player_Frc_getDuty
+ * @brief   Generate 1 output frame , call on every output clock tick.
+ * @param   pu16out     is the pointer to output duty buffer.
+ * @return  Output duty amount , 0 when no input frame has been received.
+ */
+extern uint16_t App_Player_Frc_getDuty(uint16_t *pu16out);
+
+/*!@fn      App_Player_Frc_getInputPeriod
+ * @return  Measured input frame period , unit in 1/16 output frame (e.g. 60Hz -> 120Hz = 32).
+ */
+extern uint16_t App_Player_Frc_getInputPeriod(void);
+
+#endif /* APP_APP_PLAYER_FRC_H_ */
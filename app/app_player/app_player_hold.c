@@ -0,0 +1,136 @@
+/**@file    app_player_hold.c
+ *
+ * Local Dimming player input loss handling.
+ * Hold last valid frame , fade to safe duty , and resume softly when valid input returns.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version , input loss hold & fade.
+ */
+
+#include "app_player_hold.h"
+#include "hal.h"
+
+/******************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+static uint32_t Player_HoldFrameTick = 0;       //CS end tick of last valid input frame.
+static uint32_t Player_HoldTicks = 0;           //Hold time in clock ticks , 0 = input loss handling disabled.
+static uint16_t Player_HoldFadeStep = PLAYER_HOLD_MIX_BASE;
+static uint16_t Player_HoldResumeStep = PLAYER_HOLD_MIX_BASE;
+static uint16_t Player_HoldSafeDuty = 0;
+static tPlayer_HoldStat Player_HoldStat;
+
+/******************************************************************************
+ * Internal Functions.
+ *****************************************************************************/
+/*!@brief   Mix ratio step per output frame , ramp of [frames] output frames.*/
+uint16_t Player_Hold_getStep(uint8_t frames)
+{
+    return frames ? (PLAYER_HOLD_MIX_BASE + frames - 1) / frames : PLAYER_HOLD_MIX_BASE;
+}
+
+/*!@brief   Output = Live + (Safe - Live) * Mix .*/
+void Player_Hold_mix(uint16_t *pu16duty, uint16_t duty_size, uint16_t mix)
+{
+    uint16_t i;
+
+    if (mix >= PLAYER_HOLD_MIX_BASE)
+    {
+        for (i = 0; i < duty_size; i++)
+        {
+            pu16duty[i] = Player_HoldSafeDuty;
+        }
+        return;
+    }
+
+    for (i = 0; i < duty_size; i++)
+    {
+        pu16duty[i] += (int16_t) (((int32_t) ((int16_t) Player_HoldSafeDuty - (int16_t) pu16duty[i]) * (int16_t) mix)
+                >> PLAYER_HOLD_MIX_BIT);
+    }
+}
+
+/******************************************************************************
+ * External Functions.
+ *****************************************************************************/
+void App_Player_Hold_init(uint16_t hold_ms, uint8_t fade_frames, uint8_t resume_frames, uint16_t safe_duty)
+{
+    Player_HoldTicks = CLOCK_MS_TO_TICK(hold_ms);
+    Player_HoldFadeStep = Player_Hold_getStep(fade_frames);
+    Player_HoldResumeStep = Player_Hold_getStep(resume_frames);
+    Player_HoldSafeDuty = safe_duty & 0x0FFF;
+
+    //Hold time counts from now until 1st valid input frame.
+    Player_HoldFrameTick = Clock_getTick();
+    Player_HoldStat.State = PHOLD_NORMAL;
+    Player_HoldStat.Mix = 0;
+}
+
+void App_Player_Hold_feed(uint32_t frame_tick)
+{
+    Player_HoldFrameTick = frame_tick;
+
+    if ((Player_HoldStat.State == PHOLD_FADE) || (Player_HoldStat.State == PHOLD_SAFE))
+    {
+        Player_HoldStat.State = PHOLD_RESUME;
+        Player_HoldStat.ResumeCount++;
+    }
+}
+
+void App_Player_Hold(uint16_t *pu16duty, uint16_t duty_size)
+{
+    //Input lost , or lost again while resuming.
+    if ((Player_HoldTicks) && ((Player_HoldStat.State == PHOLD_NORMAL) || (Player_HoldStat.State == PHOLD_RESUME))
+            && (Clock_getTick() - Player_HoldFrameTick > Player_HoldTicks))
+    {
+        Player_HoldStat.State = PHOLD_FADE;
+        Player_HoldStat.LossCount++;
+    }
+
+    switch (Player_HoldStat.State)
+    {
+    case PHOLD_NORMAL:
+    {
+        //Normal path , input is alive.
+        return;
+    }
+    case PHOLD_FADE:
+    {
+        Player_HoldStat.Mix += Player_HoldFadeStep;
+        if (Player_HoldStat.Mix >= PLAYER_HOLD_MIX_BASE)
+        {
+            Player_HoldStat.Mix = PLAYER_HOLD_MIX_BASE;
+            Player_HoldStat.State = PHOLD_SAFE;
+        }
+        break;
+    }
+    case PHOLD_RESUME:
+    {
+        if (Player_HoldStat.Mix > Player_HoldResumeStep)
+        {
+            Player_HoldStat.Mix -= Player_HoldResumeStep;
+        }
+        else
+        {
+            //Back to live duty.
+            Player_HoldStat.Mix = 0;
+            Player_HoldStat.State = PHOLD_NORMAL;
+            return;
+        }
+        break;
+    }
+    default:
+    {
+        break;
+    }
+    }
+
+    Player_Hold_mix(pu16duty, duty_size, Player_HoldStat.Mix);
+}
+
+tPlayer_HoldStat *App_Player_Hold_getStat(void)
+{
+    return &Player_HoldStat;
+}
@@ -0,0 +1,76 @@
+/**@file    app_player_hold.h
+ *
+ * Local Dimming player input loss handling.
+ * When valid SPI input stops (disconnected or rejected frames) , the last valid frame is held for a while ,
+ * then output fades to a safe duty. When valid input returns , output steps back softly.
+ *
+ * NORMAL --(no valid input for hold time)--> FADE --(ramp done)--> SAFE
+ *   ^                                           |                      |
+ *   +------(ramp done)------ RESUME <--(valid input)-------------------+
+ *
+ * Frame age is the time since CS end of the last valid input frame (SPI slave CS edge tick) ,
+ * a slow main loop does not stretch the hold time. Fade & resume ramps step once per output frame.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version.
+ */
+
+#ifndef APP_APP_PLAYER_HOLD_H_
+#define APP_APP_PLAYER_HOLD_H_
+
+#include "stdint.h"
+#include "app_player.h"
+
+#define PLAYER_HOLD_MIX_BIT         8       //Mix ratio resolution , 1.0 = 256 = safe duty only.
+#define PLAYER_HOLD_MIX_BASE        (1 << PLAYER_HOLD_MIX_BIT)
+
+typedef enum PLAYER_HOLD_STATE
+{
+    PHOLD_NORMAL = 0x00,            //Valid input received within hold time , output live duty.
+    PHOLD_FADE = 0x01,              //Input lost , fading from last valid frame to safe duty.
+    PHOLD_SAFE = 0x02,              //Input lost , output safe duty.
+    PHOLD_RESUME = 0x03,            //Input returned , fading from safe duty to live duty.
+
+    PHOLD_BOTTOM = 0xFF
+} PLAYER_HOLD_STATE;
+
+typedef struct tPlayer_HoldStat
+{
+    PLAYER_HOLD_STATE State;
+    uint16_t Mix;                   //Current mix ratio of safe duty , 0 ~ PLAYER_HOLD_MIX_BASE.
+    uint16_t LossCount;             //Times of input loss.
+    uint16_t ResumeCount;           //Times of input resume.
+} tPlayer_HoldStat;
+
+/*!@fn      App_Player_Hold_init
+ * @brief   Set input loss handling parameters & reset to NORMAL state.
+ *
+ * @param   hold_ms         is the time [ms] to hold last valid frame , 0 = input loss handling disabled.
+ * @param   fade_frames     is the output frames to fade to safe duty , 0 = switch immediately.
+ * @param   resume_frames   is the output frames to fade back to live duty , 0 = switch immediately.
+ * @param   safe_duty       is the 12bit duty output when input is lost.
+ */
+extern void App_Player_Hold_init(uint16_t hold_ms, uint8_t fade_frames, uint8_t resume_frames, uint16_t safe_duty);
+
+/*!@fn      App_Player_Hold_feed
+ * @brief   Restart frame age , call when valid SPI input frame is received.
+ * @param   frame_tick  is the CS end tick of the frame , SpiSlave_getFrameTick().
+ */
+extern void App_Player_Hold_feed(uint32_t frame_tick);
+
+/*!@fn      App_Player_Hold
+ * @brief   Process 1 output frame , call on every output frame before PLIMIT.
+ *
+ * @param   pu16duty    is the pointer to output duty , mixed with safe duty in place when input is lost.
+ * @param   duty_size   is the duty amount.
+ */
+extern void App_Player_Hold(uint16_t *pu16duty, uint16_t duty_size);
+
+/*!@fn      App_Player_Hold_getStat
+ * @return  Pointer to input loss handling status.
+ */
+extern tPlayer_HoldStat *App_Player_Hold_getStat(void);
+
+#endif /* APP_APP_PLAYER_HOLD_H_ */
@@ -0,0 +1,273 @@
+/**@file    app_player_input.c
+ *
+ * Local Dimming player SPI input frame validation & input format detection.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version , SPI input frame checking.
+ */
+
+#include "app_player_input.h"
+
+/******************************************************************************
+ * Operation define.
+ *****************************************************************************/
+#define PLAYER_IN_CH_MAX            128     //Maximum duty amount of 1 frame.
+
+/******************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+static PLAYER_INPUT_MODEL Player_InModel = IN_DISABLE;
+static uint16_t Player_InChAmount = 0;
+static uint8_t Player_InCheck = 0;
+static PLAYER_INPUT_MODEL Player_InCandidate = IN_DISABLE;   //Detect result of last frame.
+static uint8_t Player_InCandidateCount = 0;                  //Continuous frames of the same detect result.
+static uint8_t Player_InLockErrCount = 0;                    //Continuous error frames after format locked.
+static tPlayer_InStat Player_InStat;
+
+//CRC8 , polynomial = x^8 + x^2 + x + 1 (0x07) , initial value = 0x00.
+static const uint8_t PLAYER_IN_CRC8_TABLE[256] =
+{
+        0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+        0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+        0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+        0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+        0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+        0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+        0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+        0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+        0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+        0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+        0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+        0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+        0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+        0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+        0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+        0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+/******************************************************************************
+ * Internal Functions.
+ *****************************************************************************/
+uint8_t Player_In_getCrc8(uint8_t *pu8data, uint16_t len)
+{
+    uint8_t crc = 0x00;
+    while (len--)
+    {
+        crc = PLAYER_IN_CRC8_TABLE[crc ^ *pu8data++];
+    }
+    return crc;
+}
+
+/*!@brief   Get duty payload size of input model , 0 = not fixed.*/
+uint16_t Player_In_getPayloadSize(PLAYER_INPUT_MODEL emodel, uint16_t ch_amount)
+{
+    switch (emodel)
+    {
+    case IN_D8_P8:
+        return ch_amount;
+    case IN_D12_P8X1_5:
+        return (ch_amount * 3 + 1) / 2;
+    case IN_D12_P8X2:
+        return ch_amount * 2;
+    case IN_MFC11_SU860A_6X10:
+        return 60 * 3 / 2;
+    case IN_MFC11_SU860A_6X13:
+        return 78 * 3 / 2;
+    default:
+        return 0;
+    }
+}
+
+/*!@brief   Check payload size of input model.
+ * @return  1 : Size is valid , 0 : Size is invalid.
+ */
+uint8_t Player_In_checkSize(PLAYER_INPUT_MODEL emodel, uint16_t size)
+{
+    uint16_t expect = Player_In_getPayloadSize(emodel, Player_InChAmount);
+
+    switch (emodel)
+    {
+    case IN_MFC11_SU860A_6X10:
+    case IN_MFC11_SU860A_6X13:
+        //D0 + D1 + ... + DN + TAIL , tail length is not fixed.
+        return (size >= expect) && (size <= expect + PLAYER_IN_MFC11_TAIL_MAX);
+    case IN_D8_P8:
+    case IN_D12_P8X1_5:
+    case IN_D12_P8X2:
+        if (expect)
+        {
+            return size == expect;
+        }
+        //Zone amount unknown , only check packet alignment & maximum size.
+        if (emodel == IN_D12_P8X1_5)
+        {
+            return (size % 3 == 0) && (size <= PLAYER_IN_CH_MAX * 3 / 2);
+        }
+        if (emodel == IN_D12_P8X2)
+        {
+            return (size % 2 == 0) && (size <= PLAYER_IN_CH_MAX * 2);
+        }
+        return (size != 0) && (size <= PLAYER_IN_CH_MAX);
+    default:
+        return 0;
+    }
+}
+
+/*!@brief   Detect input format of 1 frame.
+ * @return  Detected input model ,
+ *          IN_DISABLE : No information in this frame (e.g. black frame) ,
+ *          IN_BOTTOM  : Frame does not match any format.
+ */
+PLAYER_INPUT_MODEL Player_In_detect(uint8_t *pu8data, uint16_t size)
+{
+    uint16_t i;
+    uint8_t or_all = 0;
+    uint8_t or_high = 0;    //High nibble of even bytes , always 0 when 12bit data is 16bit aligned.
+
+    for (i = 0; i < size; i++)
+    {
+        or_all |= pu8data[i];
+        if ((i & 0x01) == 0)
+        {
+            or_high |= pu8data[i];
+        }
+    }
+    or_high &= 0xF0;
+
+    if (Player_InChAmount)
+    {
+        //Zone amount known , size decides the format.
+        if ((size == Player_InChAmount * 2) && (or_high == 0))
+        {
+            return IN_D12_P8X2;
+        }
+        if (size == (Player_InChAmount * 3 + 1) / 2)
+        {
+            return IN_D12_P8X1_5;
+        }
+        if (size == Player_InChAmount)
+        {
+            return IN_D8_P8;
+        }
+        return IN_BOTTOM;
+    }
+
+    //Zone amount unknown , decide by bit pattern.
+    if (or_all == 0)
+    {
+        return IN_DISABLE;
+    }
+    if ((size % 2 == 0) && (or_high == 0))
+    {
+        return IN_D12_P8X2;
+    }
+    if (size % 3 == 0)
+    {
+        return IN_D12_P8X1_5;
+    }
+    return IN_D8_P8;
+}
+
+/******************************************************************************
+ * External Functions.
+ *****************************************************************************/
+void App_Player_Input_init(PLAYER_INPUT_MODEL emodel, uint16_t ch_amount, uint8_t check)
+{
+    Player_InModel = emodel;
+    Player_InChAmount = ch_amount;
+    Player_InCheck = check;
+    Player_InCandidate = IN_DISABLE;
+    Player_InCandidateCount = 0;
+    Player_InLockErrCount = 0;
+    Player_InStat.DetectModel = IN_DISABLE;
+}
+
+uint8_t *App_Player_Input_check(uint8_t *pu8frame, uint16_t *psize, PLAYER_INPUT_MODEL *pemodel)
+{
+    uint16_t size = *psize;
+
+    //1 Check & remove CRC tail.
+    if (Player_InCheck & PLAYER_IN_CHECK_CRC)
+    {
+        if ((size < 2) || (Player_In_getCrc8(pu8frame, size - 1) != pu8frame[size - 1]))
+        {
+            Player_InStat.ErrCrc++;
+            return 0;
+        }
+        size--;
+    }
+
+    //2 Check & remove header.
+    if (Player_InCheck & PLAYER_IN_CHECK_HEAD)
+    {
+        if ((size < 1) || (pu8frame[0] != PLAYER_IN_HEAD))
+        {
+            Player_InStat.ErrHead++;
+            return 0;
+        }
+        pu8frame++;
+        size--;
+    }
+
+    //3 Detect input format.
+    PLAYER_INPUT_MODEL emodel = *pemodel;
+    if (emodel == IN_AUTO)
+    {
+        if (Player_InStat.DetectModel == IN_DISABLE)
+        {
+            PLAYER_INPUT_MODEL detect = Player_In_detect(pu8frame, size);
+
+            if (detect == IN_DISABLE)
+            {
+                //No information , keep current result.
+            }
+            else if (detect == Player_InCandidate)
+            {
+                Player_InCandidateCount++;
+            }
+            else
+            {
+                Player_InCandidate = detect;
+                Player_InCandidateCount = 1;
+            }
+
+            if ((Player_InCandidate == IN_BOTTOM) || (Player_InCandidateCount < PLAYER_IN_DETECT_FRAMES))
+            {
+                Player_InStat.ErrDetect++;
+                return 0;
+            }
+
+            //Lock format.
+            Player_InStat.DetectModel = Player_InCandidate;
+            Player_InLockErrCount = 0;
+        }
+        emodel = Player_InStat.DetectModel;
+    }
+
+    //4 Check length. Detected format is always checked , unlock when keep failing.
+    if ((Player_InCheck & PLAYER_IN_CHECK_LEN) || (*pemodel == IN_AUTO))
+    {
+        if (!Player_In_checkSize(emodel, size))
+        {
+            Player_InStat.ErrLen++;
+            if ((*pemodel == IN_AUTO) && (++Player_InLockErrCount >= PLAYER_IN_DETECT_FRAMES))
+            {
+                App_Player_Input_init(Player_InModel, Player_InChAmount, Player_InCheck);
+            }
+            return 0;
+        }
+        Player_InLockErrCount = 0;
+    }
+
+    Player_InStat.FrameOk++;
+    *psize = size;
+    *pemodel = emodel;
+    return pu8frame;
+}
+
+tPlayer_InStat *App_Player_Input_getStat(void)
+{
+    return &Player_InStat;
+}
@@ -0,0 +1,66 @@
+/**@file    app_player_input.h
+ *
+ * Local Dimming player SPI input frame validation & input format detection.
+ *
+ * Every received SPI frame is checked before decoding :
+ * 1 Frame length according to input model & input zone amount.
+ * 2 Optional header byte & CRC8 tail.
+ * With IN_AUTO input model , 8bit / 12bit packed / 12bit aligned format is detected
+ * from frame length & bit pattern of several frames.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version.
+ */
+
+#ifndef APP_APP_PLAYER_INPUT_H_
+#define APP_APP_PLAYER_INPUT_H_
+
+#include "stdint.h"
+#include "app_player.h"
+
+//Control BIT define of [ PLAYER_PARAM.pin_check ]
+#define PLAYER_IN_CHECK_LEN         0x01    //Check frame length.
+#define PLAYER_IN_CHECK_HEAD        0x02    //Frame starts with PLAYER_IN_HEAD.
+#define PLAYER_IN_CHECK_CRC         0x04    //Frame ends with CRC8 of all bytes before.
+
+#define PLAYER_IN_HEAD              0xA5    //Frame header value.
+#define PLAYER_IN_MFC11_TAIL_MAX    3       //MFC11 sends unknown tail after duty , maximum byte allowed.
+#define PLAYER_IN_DETECT_FRAMES     4       //Frames of the same result to lock detected format.
+
+typedef struct tPlayer_InStat
+{
+    uint16_t FrameOk;                       //Valid frames.
+    uint16_t ErrLen;                        //Frames rejected by length check.
+    uint16_t ErrHead;                       //Frames rejected by header check.
+    uint16_t ErrCrc;                        //Frames rejected by CRC check.
+    uint16_t ErrDetect;                     //Frames dropped while detecting input format.
+    PLAYER_INPUT_MODEL DetectModel;         //Detected input format , IN_DISABLE = not detected yet.
+} tPlayer_InStat;
+
+/*!@fn      App_Player_Input_init
+ * @brief   Set input checking parameters , call when input model changes.
+ *
+ * @param   emodel      is the input model.
+ * @param   ch_amount   is the input zone amount , 0 = unknown.
+ * @param   check       is the checking control bits , PLAYER_IN_CHECK_XXX.
+ */
+extern void App_Player_Input_init(PLAYER_INPUT_MODEL emodel, uint16_t ch_amount, uint8_t check);
+
+/*!@fn      App_Player_Input_check
+ * @brief   Validate 1 received SPI frame.
+ *
+ * @param   pu8frame    is the pointer to received frame.
+ * @param   psize       is the pointer to frame size , replaced with duty payload size when valid.
+ * @param   pemodel     is the pointer to input model , replaced with detected format when IN_AUTO.
+ * @return  Pointer to duty payload , 0 when frame is rejected.
+ */
+extern uint8_t *App_Player_Input_check(uint8_t *pu8frame, uint16_t *psize, PLAYER_INPUT_MODEL *pemodel);
+
+/*!@fn      App_Player_Input_getStat
+ * @return  Pointer to input frame statistics.
+ */
+extern tPlayer_InStat *App_Player_Input_getStat(void);
+
+#endif /* APP_APP_PLAYER_INPUT_H_ */
@@ -0,0 +1,260 @@
+/**@file    app_player_resample.c
+ *
+ * Local Dimming player spatial resampling.
+ * Map duty of input zone grid (e.g. MFC11 6x10) to output zone grid (e.g. IW7027 16x1).
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version , zone grid resampling.
+ */
+
+#include "app_player_resample.h"
+#include "hal.h"
+
+/******************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+static PLAYER_RESAMPLE_MODE Player_RsMode = PRS_DISABLE;
+static tPlayer_RsAxis Player_RsCol;                 //Horizontal weight table.
+static tPlayer_RsAxis Player_RsRow;                 //Vertical weight table.
+
+/******************************************************************************
+ * Internal Functions.
+ *****************************************************************************/
+#define PLAYER_RS_LOG               DLOG
+
+/*!@brief   Build box (area weighted) table of 1 axis.
+ *          Each input zone is [out] units wide , each output zone is [in] units wide ,
+ *          weight = overlap length / output zone width.
+ */
+PLAYER_RET Player_Rs_buildBox(tPlayer_RsAxis *axis)
+{
+    uint16_t o, i;
+    uint8_t pos = 0;
+
+    for (o = 0; o < axis->Out; o++)
+    {
+        uint16_t o_start = o * axis->In;
+        uint16_t o_end = o_start + axis->In;
+        uint16_t first = o_start / axis->Out;
+        uint16_t last = (o_end - 1) / axis->Out;
+        uint16_t sum = 0;
+
+        if (pos + last - first + 1 > PLAYER_RS_TAP_MAX)
+        {
+            return PLAYER_FAIL;
+        }
+
+        axis->First[o] = first;
+        axis->Taps[o] = last - first + 1;
+        axis->Offset[o] = pos;
+
+        for (i = first; i <= last; i++)
+        {
+            uint16_t i_start = i * axis->Out;
+            uint16_t i_end = i_start + axis->Out;
+            uint16_t overlap = (i_end < o_end ? i_end : o_end) - (i_start > o_start ? i_start : o_start);
+
+            if (i == last)
+            {
+                //Last weight takes the rounding error , keep sum = 1.0 exactly.
+                axis->Weight[pos++] = PLAYER_RS_WEIGHT_BASE - sum;
+            }
+            else
+            {
+                axis->Weight[pos] = ((uint32_t) overlap * PLAYER_RS_WEIGHT_BASE + axis->In / 2) / axis->In;
+                sum += axis->Weight[pos++];
+            }
+        }
+    }
+    return PLAYER_SUCCESS;
+}
+
+/*!@brief   Build bilinear table of 1 axis.
+ *          Output zone center is mapped to input coordinate , interpolate between 2 nearest input zone centers.
+ */
+PLAYER_RET Player_Rs_buildBilinear(tPlayer_RsAxis *axis)
+{
+    uint16_t o;
+    uint8_t pos = 0;
+    int32_t pos_max = (int32_t) (axis->In - 1) << PLAYER_RS_WEIGHT_BIT;
+
+    for (o = 0; o < axis->Out; o++)
+    {
+        //Center position in input coordinate : x = (o + 0.5) * in / out - 0.5
+        int32_t x = ((int32_t) (2 * o + 1) * axis->In << PLAYER_RS_WEIGHT_BIT) / (2 * axis->Out)
+                - PLAYER_RS_WEIGHT_BASE / 2;
+        if (x < 0)
+        {
+            x = 0;
+        }
+        if (x > pos_max)
+        {
+            x = pos_max;
+        }
+
+        uint16_t frac = x & (PLAYER_RS_WEIGHT_BASE - 1);
+
+        axis->First[o] = x >> PLAYER_RS_WEIGHT_BIT;
+        axis->Offset[o] = pos;
+        if (frac == 0)
+        {
+            axis->Taps[o] = 1;
+            axis->Weight[pos++] = PLAYER_RS_WEIGHT_BASE;
+        }
+        else
+        {
+            axis->Taps[o] = 2;
+            axis->Weight[pos++] = PLAYER_RS_WEIGHT_BASE - frac;
+            axis->Weight[pos++] = frac;
+        }
+    }
+    return PLAYER_SUCCESS;
+}
+
+PLAYER_RET Player_Rs_buildAxis(tPlayer_RsAxis *axis, PLAYER_RESAMPLE_MODE mode, uint8_t in, uint8_t out)
+{
+    if ((in == 0) || (out == 0) || (in > PLAYER_RS_AXIS_MAX) || (out > PLAYER_RS_AXIS_MAX))
+    {
+        return PLAYER_FAIL;
+    }
+
+    axis->In = in;
+    axis->Out = out;
+
+    switch (mode)
+    {
+    case PRS_BOX:
+    case PRS_MAX_POOL:
+    {
+        //Max pool uses the same footprint as box , weights are ignored.
+        return Player_Rs_buildBox(axis);
+    }
+    case PRS_BILINEAR:
+    {
+        return Player_Rs_buildBilinear(axis);
+    }
+    default:
+    {
+        return PLAYER_FAIL;
+    }
+    }
+}
+
+/*!@brief   Weighted sum , output = sum(in[y][x] * wy * wx) .*/
+uint16_t Player_Rs_doWeight(uint16_t *pu16in, uint8_t r, uint8_t c)
+{
+    uint16_t *wy = &Player_RsRow.Weight[Player_RsRow.Offset[r]];
+    uint16_t *wx = &Player_RsCol.Weight[Player_RsCol.Offset[c]];
+    uint8_t ty, tx;
+    uint32_t acc = 0;
+
+    for (ty = 0; ty < Player_RsRow.Taps[r]; ty++)
+    {
+        uint16_t *src = &pu16in[(Player_RsRow.First[r] + ty) * Player_RsCol.In + Player_RsCol.First[c]];
+        uint32_t hacc = 0;
+
+        for (tx = 0; tx < Player_RsCol.Taps[c]; tx++)
+        {
+            hacc += (uint32_t) src[tx] * wx[tx];
+        }
+        acc += hacc * wy[ty];
+    }
+
+    return (acc + (1UL << (2 * PLAYER_RS_WEIGHT_BIT - 1))) >> (2 * PLAYER_RS_WEIGHT_BIT);
+}
+
+/*!@brief   Max pool , output = max(in[y][x]) of covered input zones.*/
+uint16_t Player_Rs_doMaxPool(uint16_t *pu16in, uint8_t r, uint8_t c)
+{
+    uint8_t ty, tx;
+    uint16_t max = 0;
+
+    for (ty = 0; ty < Player_RsRow.Taps[r]; ty++)
+    {
+        uint16_t *src = &pu16in[(Player_RsRow.First[r] + ty) * Player_RsCol.In + Player_RsCol.First[c]];
+
+        for (tx = 0; tx < Player_RsCol.Taps[c]; tx++)
+        {
+            if (src[tx] > max)
+            {
+                max = src[tx];
+            }
+        }
+    }
+
+    return max;
+}
+
+/******************************************************************************
+ * External Functions.
+ *****************************************************************************/
+PLAYER_RET App_Player_Resample_init(PLAYER_RESAMPLE_MODE mode, uint8_t in_col, uint8_t in_row, uint8_t out_col,
+        uint8_t out_row)
+{
+    Player_RsMode = PRS_DISABLE;
+
+    if (mode == PRS_DISABLE)
+    {
+        return PLAYER_SUCCESS;
+    }
+
+    //Each grid is stored in 1 duty buffer of player.
+    if (((uint16_t) in_col * in_row > PLAYER_DUTY_CH_MAX) || ((uint16_t) out_col * out_row > PLAYER_DUTY_CH_MAX))
+    {
+        PLAYER_RS_LOG("\r\nFUNC:[%s] ERROR : grid %dx%d -> %dx%d , more than %d zones.", __FUNCTION__, in_col,
+                in_row, out_col, out_row, PLAYER_DUTY_CH_MAX);
+        return PLAYER_FAIL;
+    }
+
+    //Same grid , no need resampling.
+    if ((in_col == out_col) && (in_row == out_row))
+    {
+        return PLAYER_SUCCESS;
+    }
+
+    if ((Player_Rs_buildAxis(&Player_RsCol, mode, in_col, out_col) == PLAYER_FAIL)
+            || (Player_Rs_buildAxis(&Player_RsRow, mode, in_row, out_row) == PLAYER_FAIL))
+    {
+        PLAYER_RS_LOG("\r\nFUNC:[%s] ERROR : mode = %x , grid %dx%d -> %dx%d not supported.", __FUNCTION__, mode,
+                in_col, in_row, out_col, out_row);
+        return PLAYER_FAIL;
+    }
+
+    Player_RsMode = mode;
+    return PLAYER_SUCCESS;
+}
+
+uint8_t App_Player_Resample_isEnabled(void)
+{
+    return Player_RsMode != PRS_DISABLE;
+}
+
+uint16_t App_Player_Resample(uint16_t *pu16in, uint16_t *pu16out)
+{
+    if (Player_RsMode == PRS_DISABLE)
+    {
+        return 0;
+    }
+
+    uint8_t r, c;
+    uint16_t i = 0;
+
+    for (r = 0; r < Player_RsRow.Out; r++)
+    {
+        for (c = 0; c < Player_RsCol.Out; c++)
+        {
+            if (Player_RsMode == PRS_MAX_POOL)
+            {
+                pu16out[i++] = Player_Rs_doMaxPool(pu16in, r, c);
+            }
+            else
+            {
+                pu16out[i++] = Player_Rs_doWeight(pu16in, r, c);
+            }
+        }
+    }
+
+    return i;
+}
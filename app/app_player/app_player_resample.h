@@ -0,0 +1,65 @@
+/**@file    app_player_resample.h
+ *
+ * Local Dimming player spatial resampling.
+ * Map duty of input zone grid (e.g. MFC11 6x10) to output zone grid (e.g. IW7027 16x1).
+ *
+ * Weight tables of each axis are built once by App_Player_Resample_init() ,
+ * the per frame process is only a multiply-accumulate loop.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version.
+ */
+
+#ifndef APP_APP_PLAYER_RESAMPLE_H_
+#define APP_APP_PLAYER_RESAMPLE_H_
+
+#include "stdint.h"
+#include "app_player.h"
+
+#define PLAYER_RS_AXIS_MAX          32                          //Maximum zone amount of 1 axis.
+#define PLAYER_RS_TAP_MAX           (PLAYER_RS_AXIS_MAX * 2)    //Maximum weight amount of 1 axis.
+#define PLAYER_RS_WEIGHT_BIT        8                           //Weight resolution , 1.0 = 256.
+#define PLAYER_RS_WEIGHT_BASE       (1 << PLAYER_RS_WEIGHT_BIT)
+
+//Weight table of 1 axis.
+typedef struct tPlayer_RsAxis
+{
+    uint8_t In;                             //Input zone amount.
+    uint8_t Out;                            //Output zone amount.
+    uint8_t First[PLAYER_RS_AXIS_MAX];      //First input zone of each output zone.
+    uint8_t Taps[PLAYER_RS_AXIS_MAX];       //Input zone amount used by each output zone.
+    uint8_t Offset[PLAYER_RS_AXIS_MAX];     //Start position in Weight[] of each output zone.
+    uint16_t Weight[PLAYER_RS_TAP_MAX];     //Weight of each input zone , sum of 1 output zone = PLAYER_RS_WEIGHT_BASE.
+} tPlayer_RsAxis;
+
+/*!@fn      App_Player_Resample_init
+ * @brief   Build resampling weight tables , call when input or output model changes.
+ * @note    When input grid == output grid , resampling is disabled.
+ *
+ * @param   mode        is the resampling mode.
+ * @param   in_col      is the column amount of input zones.
+ * @param   in_row      is the row amount of input zones.
+ * @param   out_col     is the column amount of output zones.
+ * @param   out_row     is the row amount of output zones.
+ * @return  PLAYER_SUCCESS or PLAYER_FAIL (grid size not supported , resampling disabled).
+ */
+extern PLAYER_RET App_Player_Resample_init(PLAYER_RESAMPLE_MODE mode, uint8_t in_col, uint8_t in_row, uint8_t out_col,
+        uint8_t out_row);
+
+/*!@fn      App_Player_Resample_isEnabled
+ * @return  1 : Resampling is working , 0 : Input zones are passed to output directly.
+ */
+extern uint8_t App_Player_Resample_isEnabled(void);
+
+/*!@fn      App_Player_Resample
+ * @brief   Resample 1 frame of duty from input grid to output grid.
+ *
+ * @param   pu16in      is the pointer to input duty , size = in_col * in_row.
+ * @param   pu16out     is the pointer to output duty buffer , size = out_col * out_row.
+ * @return  Output duty amount , 0 when resampling is disabled.
+ */
+extern uint16_t App_Player_Resample(uint16_t *pu16in, uint16_t *pu16out);
+
+#endif /* APP_APP_PLAYER_RESAMPLE_H_ */
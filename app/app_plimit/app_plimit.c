@@ -17,6 +17,7 @@
 
 #include "app_plimit.h"
 #include "app_plimit_db.h"
+#include "app_plimit_cmd.h"
 
 /***Internal Functions********************************************************/
 
@@ -368,12 +369,12 @@ PLIMIT_RET App_PlimitPrint(tPlimit_Data *pstdata, tPlimit_Param *pstparam)
     HI_U8 temp[PLIMIT_CH_MAX];
     HI_U8 i;
 
-    PLIMIT_LOG("\r\nPLIMIT Runtime : %d", pstparam->PlimitCount);
-    PLIMIT_LOG("\r\n\t[CH]\t[DUTY]\t[LIMIT]\t[TEMP]\r\n----------------------------\r\n");
+    PLIMIT_PRINT("\r\nPLIMIT Runtime : %d", pstparam->PlimitCount);
+    PLIMIT_PRINT("\r\n\t[CH]\t[DUTY]\t[LIMIT]\t[TEMP]\r\n----------------------------\r\n");
     for (i = 0; i < pstparam->ChAmount; i++)
     {
         temp[i] = pstdata->TempDelta[i] >> PLIMIT_DUTY_BIT;
-        PLIMIT_LOG("\t[%d]\t[%x]\t[%x]\t[%d]\r\n", i, pstdata->Duty[i], pstdata->Limit[i], temp[i]);
+        PLIMIT_PRINT("\t[%d]\t[%x]\t[%x]\t[%d]\r\n", i, pstdata->Duty[i], pstdata->Limit[i], temp[i]);
     }
 
     return PLIMIT_SUCCESS;
@@ -556,3 +557,18 @@ PLIMIT_RET APP_PLIMIT_init(HI_U16 param_index)
     return App_Plimit_init(param_index, &g_stPlimitData, &g_stPlimitParam, &g_stPlimitDb);
 }
 
+PLIMIT_RET APP_PLIMIT_Cmd(HI_U8 *pu8cmd)
+{
+    return App_Plimit_Cmd(pu8cmd, &g_stPlimitData, &g_stPlimitParam, &g_stPlimitDb);
+}
+
+tPlimit_Data *APP_PLIMIT_getData(void)
+{
+    return &g_stPlimitData;
+}
+
+tPlimit_Param *APP_PLIMIT_getParam(void)
+{
+    return &g_stPlimitParam;
+}
+
@@ -35,8 +35,15 @@ typedef int HI_S16;
 typedef unsigned long HI_U32;
 typedef long HI_S32;
 
-//Log System Interface
-#define PLIMIT_LOG         printf
+//Log System Interface , bulk dump is printed at once.
+#define PLIMIT_LOG         DLOG
+#define PLIMIT_PRINT       printf
+
+//I2C command bytes , 1 mailbox of I2C slave.
+#define PLIMIT_CMD_SIZE_MAX     I2C_S_MBOX_SIZE
+
+//CRC16 CCITT of block transfer , shared with MCU HAL.
+#define PLIMIT_CRC16            Mcu_crc16
 
 #define PLIMIT_CKECK_NULL_POINTER(ptr)  \
     if (PLIMIT_NULL == ptr) \
@@ -55,6 +62,10 @@ typedef long HI_S32;
 
 //Log System Interface
 #define PLIMIT_LOG              HI_PRINT
+#define PLIMIT_PRINT            HI_PRINT
+
+//I2C command bytes.
+#define PLIMIT_CMD_SIZE_MAX     256
 
 #define PLIMIT_CKECK_NULL_POINTER(ptr)  \
     if (PLIMIT_NULL == ptr) \
@@ -278,5 +289,14 @@ extern PLIMIT_RET APP_PLIMIT_DB_getParamIndex(HI_U8 *current_index);
 
 extern PLIMIT_RET APP_PLIMIT_init(HI_U16 param_index);
 
+/*!@fn      APP_PLIMIT_getData / APP_PLIMIT_getParam
+ * @brief   Working data & parameters of APP_PLIMIT_XXX functions.
+ * @note    g_stPlimitData / g_stPlimitParam are static in this header , every file has its own copy ,
+ *          other modules must access the working copy through these functions.
+ */
+extern tPlimit_Data *APP_PLIMIT_getData(void);
+
+extern tPlimit_Param *APP_PLIMIT_getParam(void);
+
 #endif /* API_plimit_H_ */
 
@@ -26,13 +26,173 @@ typedef struct tPlimitCmd
     HI_U8 au8Param[CMD_DATA_MAX];     // Parameter
 } tPlimitCmd;
 
+/***Internal Variables********************************************************/
+
+//Block transfer shadow , applied to working tables by COMMIT only.
+static HI_U8 Plimit_BlockShadow[PLIMIT_BLOCK_SIZE_MAX];
+static HI_U8 Plimit_BlockType = PLIMIT_BLOCK_BUTT;
+static HI_U8 Plimit_BlockState = PLIMIT_BLOCK_IDLE;
+static HI_U16 Plimit_BlockLen = 0;
+static HI_U16 Plimit_BlockReceived = 0;
+
+//Working tables in RAM , build-in tables of database are constant.
+static HI_U16 Plimit_GammaRam[256];
+static HI_U16 Plimit_SafeDutyRam[PLIMIT_CH_MAX];
+static HI_U16 Plimit_SafeDutySize = 0;      //Zones loaded to Plimit_SafeDutyRam.
+
+/***Internal Functions********************************************************/
+
+static void Plimit_Cmd_copy(void *dst, const void *src, HI_U16 len)
+{
+    HI_U8 *d = dst;
+    const HI_U8 *s = src;
+    while (len--)
+    {
+        *d++ = *s++;
+    }
+}
+
+#ifndef PLIMIT_CRC16
+//CRC16 CCITT , poly 0x1021 , init 0xFFFF , for platform without MCU HAL.
+#define PLIMIT_CRC16    Plimit_Cmd_crc16
+static HI_U16 Plimit_Cmd_crc16(const HI_U8 *s, HI_U16 len)
+{
+    HI_U16 crc = 0xFFFF;
+    HI_U8 i;
+    while (len--)
+    {
+        crc ^= (HI_U16) *s++ << 8;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+#endif
+
+//Block length expected by type , 0 = unknown type.
+static HI_U16 Plimit_Cmd_blockLength(HI_U8 type, tPlimit_Param *pstparam)
+{
+    switch (type)
+    {
+    case PLIMIT_BLOCK_PARAM:
+        return sizeof(tPlimit_Param);
+    case PLIMIT_BLOCK_GAMMA:
+        return PLIMIT_GAMMA_KNOT * sizeof(HI_U16);
+    case PLIMIT_BLOCK_SAFE_DUTY:
+        return pstparam->ChAmount * sizeof(HI_U16);
+    case PLIMIT_BLOCK_ENV_TEMP:
+        return pstparam->ChAmount;
+    default:
+        return 0;
+    }
+}
+
+//Zones of active safe duty table , RAM table by upload , build-in table by database params using it.
+static HI_U16 Plimit_Cmd_safeDutySize(tPlimit_Param *pstparam, tPlimit_Db *pstdb)
+{
+    HI_U16 size = 0;
+    HI_U8 i;
+
+    if (pstparam->DutyTempSafePtr == Plimit_SafeDutyRam)
+    {
+        return Plimit_SafeDutySize;
+    }
+    for (i = 0; (i < pstdb->total_index) && (i < PLIMIT_DB_PARAM_MAX); i++)
+    {
+        if ((pstdb->pstParamList[i]->DutyTempSafePtr == pstparam->DutyTempSafePtr)
+                && (pstdb->pstParamList[i]->ChAmount > size))
+        {
+            size = pstdb->pstParamList[i]->ChAmount;
+        }
+    }
+    //Unknown table , only current zones are known valid.
+    return size ? size : pstparam->ChAmount;
+}
+
+//Check & apply shadow to working data , return ePlimitBlockState.
+static HI_U8 Plimit_Cmd_blockApply(tPlimit_Data *pstdata, tPlimit_Param *pstparam, tPlimit_Db *pstdb)
+{
+    HI_U16 i, j;
+
+    switch (Plimit_BlockType)
+    {
+    case PLIMIT_BLOCK_PARAM:
+    {
+        tPlimit_Param param;
+        HI_U8 ch_amount = pstparam->ChAmount;
+
+        Plimit_Cmd_copy(&param, Plimit_BlockShadow, sizeof(param));
+        //Table pointers are kept , zones must be covered by the active safe duty table.
+        if ((param.ChAmount == 0) || (param.ChAmount > PLIMIT_CH_MAX) || (param.FramePerSample == 0)
+                || (param.CoefD >= PLIMIT_COEF_BASE) || (param.ChAmount > Plimit_Cmd_safeDutySize(pstparam, pstdb)))
+        {
+            return PLIMIT_BLOCK_ERR_VALUE;
+        }
+        param.GammaTable = pstparam->GammaTable;
+        param.DutyTempSafePtr = pstparam->DutyTempSafePtr;
+        *pstparam = param;
+        if (param.ChAmount != ch_amount)
+        {
+            App_Plimit_resetDataBuf(pstdata, pstparam);
+        }
+        App_Plimit_setSafeTemp(pstdata, pstparam);
+        break;
+    }
+    case PLIMIT_BLOCK_GAMMA:
+    {
+        HI_U16 knot[PLIMIT_GAMMA_KNOT];
+
+        Plimit_Cmd_copy(knot, Plimit_BlockShadow, sizeof(knot));
+        for (i = 0; i < PLIMIT_GAMMA_KNOT; i++)
+        {
+            if ((knot[i] > PLIMIT_DUTY_MAX) || (i && (knot[i] < knot[i - 1])))
+            {
+                return PLIMIT_BLOCK_ERR_VALUE;
+            }
+        }
+        //Linear between knots at 0x00 0x20 ... 0x100 .
+        for (i = 0; i < PLIMIT_GAMMA_KNOT - 1; i++)
+        {
+            for (j = 0; j < 0x20; j++)
+            {
+                Plimit_GammaRam[0x20 * i + j] = knot[i] + (HI_U32) (knot[i + 1] - knot[i]) * j / 0x20;
+            }
+        }
+        pstparam->GammaTable = Plimit_GammaRam;
+        break;
+    }
+    case PLIMIT_BLOCK_SAFE_DUTY:
+        Plimit_Cmd_copy(Plimit_SafeDutyRam, Plimit_BlockShadow, Plimit_BlockLen);
+        for (i = 0; i < pstparam->ChAmount; i++)
+        {
+            if (Plimit_SafeDutyRam[i] > PLIMIT_DUTY_MAX)
+            {
+                Plimit_SafeDutyRam[i] = PLIMIT_DUTY_MAX;
+            }
+        }
+        pstparam->DutyTempSafePtr = Plimit_SafeDutyRam;
+        Plimit_SafeDutySize = pstparam->ChAmount;
+        App_Plimit_setSafeTemp(pstdata, pstparam);
+        break;
+    case PLIMIT_BLOCK_ENV_TEMP:
+        Plimit_Cmd_copy(pstdata->TempSafe, Plimit_BlockShadow, Plimit_BlockLen);
+        break;
+    default:
+        return PLIMIT_BLOCK_ERR_PARAM;
+    }
+    return PLIMIT_BLOCK_IDLE;
+}
+
 /***External Functions********************************************************/
 
 //I2C Slave Write Interface
 PLIMIT_RET Plimit_Cmd_WriteI2CSlaveBuf(HI_U8 *pu8data, HI_U8 length)
 {
 #ifdef PLIMIT_LIB_USE_ON_MSP430
-    //TBD.
+    //Read back by host from I2C slave mailbox.
+    I2cSlave_puts(pu8data, length);
 #endif
 #ifdef PLIMIT_LIB_USE_ON_HISILICON
     //HI_DRV_I2C_S_Write(HI_DRV_I2C_S_ADDR_ID_0, pu8data, length );
@@ -264,6 +424,76 @@ PLIMIT_RET App_Plimit_Cmd(HI_U8 *pu8cmd, tPlimit_Data *pstdata, tPlimit_Param *p
         }
         break;
     }
+    case CUS_PLIMIT_BLOCK_BEGIN:
+    {
+        HI_U16 i, len;
+
+        len = (HI_U16) pstcmd->au8Param[1] * 0x100 + pstcmd->au8Param[2];
+        Plimit_BlockType = pstcmd->au8Param[0];
+        Plimit_BlockLen = Plimit_Cmd_blockLength(Plimit_BlockType, pstparam);
+        Plimit_BlockReceived = 0;
+        if ((Plimit_BlockLen == 0) || (Plimit_BlockLen != len) || (len > PLIMIT_BLOCK_SIZE_MAX))
+        {
+            Plimit_BlockState = PLIMIT_BLOCK_ERR_PARAM;
+            break;
+        }
+        for (i = 0; i < len; i++)
+        {
+            Plimit_BlockShadow[i] = 0x00;
+        }
+        Plimit_BlockState = PLIMIT_BLOCK_LOADING;
+        break;
+    }
+    case CUS_PLIMIT_BLOCK_DATA:
+    {
+        HI_U16 offset;
+        HI_U8 len;
+
+        offset = (HI_U16) pstcmd->au8Param[0] * 0x100 + pstcmd->au8Param[1];
+        len = pstcmd->au8Param[2];
+        if ((Plimit_BlockState != PLIMIT_BLOCK_LOADING) && (Plimit_BlockState != PLIMIT_BLOCK_ERR_CRC))
+        {
+            break;
+        }
+        if ((len > PLIMIT_BLOCK_CHUNK_MAX) || ((HI_U32) offset + len > Plimit_BlockLen))
+        {
+            Plimit_BlockState = PLIMIT_BLOCK_ERR_PARAM;
+            break;
+        }
+        Plimit_Cmd_copy(&Plimit_BlockShadow[offset], &pstcmd->au8Param[3], len);
+        Plimit_BlockReceived += len;
+        Plimit_BlockState = PLIMIT_BLOCK_LOADING;
+        break;
+    }
+    case CUS_PLIMIT_BLOCK_COMMIT:
+    case CUS_PLIMIT_BLOCK_STATUS:
+    {
+        HI_U8 buf[6];
+        HI_U16 crc = PLIMIT_CRC16(Plimit_BlockShadow, Plimit_BlockLen);
+
+        if ((pstcmd->u8SubCmd == CUS_PLIMIT_BLOCK_COMMIT)
+                && ((Plimit_BlockState == PLIMIT_BLOCK_LOADING) || (Plimit_BlockState == PLIMIT_BLOCK_ERR_CRC)))
+        {
+            if (crc != (HI_U16) pstcmd->au8Param[0] * 0x100 + pstcmd->au8Param[1])
+            {
+                Plimit_BlockState = PLIMIT_BLOCK_ERR_CRC;
+            }
+            else
+            {
+                Plimit_BlockState = Plimit_Cmd_blockApply(pstdata, pstparam, pstdb);
+            }
+        }
+
+        buf[0] = Plimit_BlockState;
+        buf[1] = Plimit_BlockType;
+        buf[2] = Plimit_BlockReceived >> 8;
+        buf[3] = Plimit_BlockReceived & 0xFF;
+        buf[4] = crc >> 8;
+        buf[5] = crc & 0xFF;
+
+        Plimit_Cmd_WriteI2CSlaveBuf(buf, sizeof(buf));
+        break;
+    }
     case CUS_PLIMIT_BUTT:
     {
         break;
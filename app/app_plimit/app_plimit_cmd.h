@@ -42,10 +42,49 @@ typedef enum ePlimitSubCmd
 
     CUS_PLIMIT_RESET_DATA = 0x1E,
 
+    CUS_PLIMIT_BLOCK_BEGIN = 0x20, CUS_PLIMIT_BLOCK_DATA = 0x21,
+
+    CUS_PLIMIT_BLOCK_COMMIT = 0x22, CUS_PLIMIT_BLOCK_STATUS = 0x23,
+
     CUS_PLIMIT_BUTT = 0xFF
 
 } ePlimitSubCmd;
 
+/* Block transfer , 1 whole table uploaded in chunks to a shadow & applied in 1 commit.
+ * BEGIN  : Param[0] = ePlimitBlock , Param[1~2] = Block length.
+ * DATA   : Param[0~1] = Offset , Param[2] = Chunk length (<= PLIMIT_BLOCK_CHUNK_MAX) , Param[3~] = Data.
+ * COMMIT : Param[0~1] = CRC16 of whole block , verified on shadow , applied only when valid.
+ * STATUS : No param.
+ * COMMIT & STATUS response : [ePlimitBlockState] [Block type] [Bytes received H/L] [CRC16 of shadow H/L].
+ * 16bit params are high byte first , block data is in MCU memory layout (same as I2C register windows) :
+ *   PLIMIT_BLOCK_PARAM     : tPlimit_Param image , table pointers are kept ,
+ *                            ChAmount must not exceed zones of the active safe duty table.
+ *   PLIMIT_BLOCK_GAMMA     : HI_U16 x PLIMIT_GAMMA_KNOT , input 0x00 0x20 ... 0xE0 0x100 , expanded to 256 points.
+ *   PLIMIT_BLOCK_SAFE_DUTY : HI_U16 x ChAmount , DutyTempSafe of each zone , TempSafe recalculated.
+ *   PLIMIT_BLOCK_ENV_TEMP  : HI_U8 x ChAmount , TempSafe of each zone.
+ * CRC16 : CCITT , poly 0x1021 , init 0xFFFF.
+ */
+#define PLIMIT_BLOCK_CHUNK_HEAD         5       //Main & sub command , offset , chunk length.
+#define PLIMIT_BLOCK_CHUNK_MAX          (PLIMIT_CMD_SIZE_MAX - PLIMIT_BLOCK_CHUNK_HEAD)   //Chunk fits 1 I2C command , <= 255.
+#define PLIMIT_BLOCK_SIZE_MAX           (PLIMIT_CH_MAX * 2)
+#define PLIMIT_GAMMA_KNOT               9
+
+typedef enum ePlimitBlock
+{
+    PLIMIT_BLOCK_PARAM = 0x00, PLIMIT_BLOCK_GAMMA = 0x01, PLIMIT_BLOCK_SAFE_DUTY = 0x02, PLIMIT_BLOCK_ENV_TEMP = 0x03,
+
+    PLIMIT_BLOCK_BUTT
+} ePlimitBlock;
+
+typedef enum ePlimitBlockState
+{
+    PLIMIT_BLOCK_IDLE = 0x00,       //No block , or last block applied.
+    PLIMIT_BLOCK_LOADING = 0x01,    //BEGIN received , waiting DATA & COMMIT.
+    PLIMIT_BLOCK_ERR_PARAM = 0x02,  //Unknown type , length or chunk out of range.
+    PLIMIT_BLOCK_ERR_CRC = 0x03,    //CRC mismatch , shadow kept , resend DATA & COMMIT again.
+    PLIMIT_BLOCK_ERR_VALUE = 0x04,  //Value check fail , e.g. ChAmount.
+} ePlimitBlockState;
+
 /*!@fn      App_Plimit_Cmd
  * @brief   Handle I2C command interface for PLIMIT function.
  *
@@ -57,4 +96,9 @@ typedef enum ePlimitSubCmd
  */
 extern PLIMIT_RET App_Plimit_Cmd(HI_U8 *pu8cmd, tPlimit_Data *pstdata, tPlimit_Param *pstparam, tPlimit_Db *pstdb);
 
+/*!@fn      APP_PLIMIT_Cmd
+ * @brief   App_Plimit_Cmd() on working data of APP_PLIMIT_XXX functions.
+ */
+extern PLIMIT_RET APP_PLIMIT_Cmd(HI_U8 *pu8cmd);
+
 #endif /* APP_APP_PLIMIT_CMD_H_ */
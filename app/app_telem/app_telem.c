@@ -0,0 +1,236 @@
+/**@file    app_telem.c
+ *
+ * Binary telemetry stream of duty , power limit , thermal state , frame statistics & timing.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version , binary telemetry stream.
+ */
+
+#include "app_telem.h"
+#include "app.h"
+#include "hal.h"
+
+/******************************************************************************
+ * Operation define.
+ *****************************************************************************/
+#define TELEM_HEAD_SIZE             6
+#define TELEM_RAW_MAX               (TELEM_HEAD_SIZE + TELEM_CH_PER_PACKET * 2 + 2)
+#define TELEM_OUT_MAX               (TELEM_RAW_MAX + TELEM_RAW_MAX / 254 + 3)   //COBS overhead + 2 delimiters.
+
+//Packet type , 1 content bit each.
+#define TELEM_TYPE_DUTY             0x01
+#define TELEM_TYPE_LIMIT            0x02
+#define TELEM_TYPE_TEMP             0x03
+#define TELEM_TYPE_FRAME            0x04
+#define TELEM_TYPE_TIMING           0x05
+#define TELEM_TYPE_LOG              0x06    //Deferred log record , always sent , values = record bytes.
+
+/******************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+static uint8_t Telem_Mask = 0;
+static uint8_t Telem_Decimation = 1;
+static uint8_t Telem_DecCount = 0;
+static uint8_t Telem_Seq = 0;                          //Packet sequence , gap = packets skipped.
+static uint16_t Telem_Frame = 0;                       //Output frame count.
+static uint16_t Telem_Drop = 0;                        //Packets skipped , TX ring full.
+static uint32_t Telem_LastTick = 0;
+static uint32_t Telem_TimingTick[TELEM_TIMING_AMOUNT]; //Clock ticks , converted to us when sent.
+
+static uint8_t Telem_Raw[TELEM_RAW_MAX];
+static uint8_t Telem_Out[TELEM_OUT_MAX];
+
+/******************************************************************************
+ * Internal Functions.
+ *****************************************************************************/
+/*!@brief   COBS encode , no 0x00 in output.
+ * @return  Encoded size , delimiter not included.
+ */
+uint16_t Telem_cobs(const uint8_t *in, uint16_t len, uint8_t *out)
+{
+    uint16_t code_pos = 0;
+    uint16_t pos = 1;
+    uint8_t code = 1;
+
+    while (len--)
+    {
+        if (*in)
+        {
+            out[pos++] = *in;
+            code++;
+        }
+        if ((*in++ == 0) || (code == 0xFF))
+        {
+            out[code_pos] = code;
+            code = 1;
+            code_pos = pos++;
+        }
+    }
+    out[code_pos] = code;
+    return pos;
+}
+
+/*!@brief   Frame & queue 1 packet , skipped when UART TX ring has no space for all of it.*/
+void Telem_send(uint8_t type, uint8_t offset, uint8_t count, const uint16_t *values)
+{
+    uint8_t *p = Telem_Raw;
+    uint16_t len, crc;
+
+    *p++ = type;
+    *p++ = Telem_Seq++;
+    *p++ = Telem_Frame & 0xFF;
+    *p++ = Telem_Frame >> 8;
+    *p++ = offset;
+    *p++ = count;
+    while (count--)
+    {
+        *p++ = *values & 0xFF;
+        *p++ = *values++ >> 8;
+    }
+    crc = Mcu_crc16(Telem_Raw, p - Telem_Raw);
+    *p++ = crc & 0xFF;
+    *p++ = crc >> 8;
+
+    //Delimiter on both sides , text printed before is not merged into packet.
+    Telem_Out[0] = 0x00;
+    len = Telem_cobs(Telem_Raw, p - Telem_Raw, &Telem_Out[1]) + 1;
+    Telem_Out[len++] = 0x00;
+
+    if (Uart_getTxFree() < len)
+    {
+        Telem_Drop++;
+        return;
+    }
+    Uart_write((char *) Telem_Out, len);
+}
+
+/*!@brief   Send channel array in packets of TELEM_CH_PER_PACKET.*/
+void Telem_sendChannels(uint8_t type, const uint16_t *values, uint8_t ch_amount)
+{
+    uint8_t offset;
+    for (offset = 0; offset < ch_amount; offset += TELEM_CH_PER_PACKET)
+    {
+        uint8_t count = ch_amount - offset;
+        Telem_send(type, offset, count > TELEM_CH_PER_PACKET ? TELEM_CH_PER_PACKET : count, &values[offset]);
+    }
+}
+
+/*!@brief   Send TempDelta , converted to duty unit in packets of TELEM_CH_PER_PACKET.*/
+void Telem_sendTemp(const HI_U32 *temp, uint8_t ch_amount)
+{
+    uint16_t values[TELEM_CH_PER_PACKET];
+    uint8_t offset, i;
+
+    for (offset = 0; offset < ch_amount; offset += TELEM_CH_PER_PACKET)
+    {
+        uint8_t count = ch_amount - offset;
+        count = count > TELEM_CH_PER_PACKET ? TELEM_CH_PER_PACKET : count;
+        for (i = 0; i < count; i++)
+        {
+            uint32_t t = temp[offset + i] >> PLIMIT_DUTY_BIT;
+            values[i] = t > 0xFFFF ? 0xFFFF : t;
+        }
+        Telem_send(TELEM_TYPE_TEMP, offset, count, values);
+    }
+}
+
+void Telem_sendFrame(void)
+{
+    uint16_t values[TELEM_FRAME_AMOUNT];
+    tPlayer_InStat *in = App_Player_Input_getStat();
+    tPlayer_DrvStatus *drv = App_Player_Drv_getStatus();
+
+    values[TELEM_FRAME_IN_OK] = in->FrameOk;
+    values[TELEM_FRAME_IN_ERR] = in->ErrLen + in->ErrHead + in->ErrCrc;
+    values[TELEM_FRAME_OUT_OK] = drv->FrameCount;
+    values[TELEM_FRAME_OUT_FAIL] = drv->FrameFail;
+    values[TELEM_FRAME_OUT_BYTE] = drv->ByteCount;
+    values[TELEM_FRAME_FAULT] = drv->Fault;
+    values[TELEM_FRAME_UART_DROP] = Uart_getTxStat()->DropByte;
+    values[TELEM_FRAME_TELEM_DROP] = Telem_Drop;
+    Telem_send(TELEM_TYPE_FRAME, 0, TELEM_FRAME_AMOUNT, values);
+}
+
+/******************************************************************************
+ * External Functions.
+ *****************************************************************************/
+void App_Telem_config(uint8_t mask, uint8_t decimation)
+{
+    Telem_Mask = mask & TELEM_ALL;
+    Telem_Decimation = decimation ? decimation : 1;
+    Telem_DecCount = 0;
+}
+
+void App_Telem_setTiming(uint8_t index, uint32_t ticks)
+{
+    if (index < TELEM_TIMING_AMOUNT)
+    {
+        Telem_TimingTick[index] = ticks;
+    }
+}
+
+void App_Telem_service(void)
+{
+    uint8_t rec[DLOG_RECORD_MAX + 1];
+    uint16_t values[(DLOG_RECORD_MAX + 1) / 2];
+    uint16_t size, i;
+
+    //Records stay in deferred log ring until UART TX ring has space for the largest packet.
+    while ((Uart_getTxFree() >= TELEM_OUT_MAX) && ((size = Dlog_read(rec)) != 0))
+    {
+        rec[size] = 0x00;
+        for (i = 0; i < (size + 1) / 2; i++)
+        {
+            values[i] = rec[i * 2] | ((uint16_t) rec[i * 2 + 1] << 8);
+        }
+        Telem_send(TELEM_TYPE_LOG, 0, (size + 1) / 2, values);
+    }
+}
+
+void App_Telem_frame(void)
+{
+    uint32_t now = Clock_getTick();
+    App_Telem_setTiming(TELEM_TIMING_PERIOD, now - Telem_LastTick);
+    Telem_LastTick = now;
+    Telem_Frame++;
+
+    if ((Telem_Mask == 0) || (++Telem_DecCount < Telem_Decimation))
+    {
+        return;
+    }
+    Telem_DecCount = 0;
+
+    tPlimit_Data *data = APP_PLIMIT_getData();
+    uint8_t ch_amount = APP_PLIMIT_getParam()->ChAmount;
+
+    if (Telem_Mask & TELEM_DUTY)
+    {
+        Telem_sendChannels(TELEM_TYPE_DUTY, data->Duty, ch_amount);
+    }
+    if (Telem_Mask & TELEM_LIMIT)
+    {
+        Telem_sendChannels(TELEM_TYPE_LIMIT, data->Limit, ch_amount);
+    }
+    if (Telem_Mask & TELEM_TEMP)
+    {
+        Telem_sendTemp(data->TempDelta, ch_amount);
+    }
+    if (Telem_Mask & TELEM_FRAME)
+    {
+        Telem_sendFrame();
+    }
+    if (Telem_Mask & TELEM_TIMING)
+    {
+        uint16_t timing[TELEM_TIMING_AMOUNT];
+        uint8_t i;
+
+        for (i = 0; i < TELEM_TIMING_AMOUNT; i++)
+        {
+            uint32_t us = CLOCK_TICK_TO_US(Telem_TimingTick[i]);
+            timing[i] = us > 0xFFFF ? 0xFFFF : us;
+        }
+        Telem_send(TELEM_TYPE_TIMING, 0, TELEM_TIMING_AMOUNT, timing);
+    }
+}
@@ -0,0 +1,76 @@
+/**@file    app_telem.h
+ *
+ * Binary telemetry stream of duty , power limit , thermal state , frame statistics & timing.
+ *
+ * Packets are sent through the non-blocking UART TX ring , a packet not fitting the free ring space is skipped.
+ * Packet (before framing) , all values little endian :
+ *   [Type:1] [Seq:1] [Frame:2] [Offset:1] [Count:1] [Value:2 x Count] [CRC16:2]
+ * Framing : COBS encoded , 0x00 before & after. Text printed on the same UART fails CRC & is ignored by host.
+ * CRC16   : CCITT , poly 0x1021 , init 0xFFFF , over all bytes before CRC.
+ * Deferred log records (hal_dlog) are sent in the same stream , formatted by host with the output file.
+ * Host decoder : tools/telem_decode.py
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version.
+ */
+
+#ifndef APP_APP_TELEM_H_
+#define APP_APP_TELEM_H_
+
+#include "stdint.h"
+
+//Control BIT define of telemetry content , 1 packet type each.
+#define TELEM_DUTY                  0x01    //PLIMIT input duty , by channel.
+#define TELEM_LIMIT                 0x02    //PLIMIT duty limit , by channel.
+#define TELEM_TEMP                  0x04    //PLIMIT TempDelta >> PLIMIT_DUTY_BIT , by channel.
+#define TELEM_FRAME                 0x08    //Frame statistics , see TELEM_FRAME_XXX.
+#define TELEM_TIMING                0x10    //Frame timing , see TELEM_TIMING_XXX.
+#define TELEM_ALL                   0x1F
+
+#define TELEM_CH_PER_PACKET         32      //Channel values of 1 packet , longer arrays are sent in several packets.
+
+//Values of TELEM_FRAME packet.
+#define TELEM_FRAME_IN_OK           0       //SPI input frames valid.
+#define TELEM_FRAME_IN_ERR          1       //SPI input frames rejected , length + header + CRC.
+#define TELEM_FRAME_OUT_OK          2       //Frames sent by LED driver.
+#define TELEM_FRAME_OUT_FAIL        3       //Frames rejected by LED driver.
+#define TELEM_FRAME_OUT_BYTE        4       //SPI bytes of last output frame.
+#define TELEM_FRAME_FAULT           5       //Faulty LED driver devices , bit = device.
+#define TELEM_FRAME_UART_DROP       6       //UART TX bytes dropped.
+#define TELEM_FRAME_TELEM_DROP      7       //Telemetry packets skipped , TX ring full.
+#define TELEM_FRAME_AMOUNT          8
+
+//Values of TELEM_TIMING packet , unit in us , saturated at 0xFFFF.
+#define TELEM_TIMING_PERIOD         0       //Output frame period.
+#define TELEM_TIMING_PLIMIT         1       //Power limit calculation.
+#define TELEM_TIMING_OUTPUT         2       //Duty packing & sending to LED driver.
+#define TELEM_TIMING_INPUT          3       //SPI input frame period , between CS rising edges.
+#define TELEM_TIMING_AMOUNT         4
+
+/*!@fn      App_Telem_config
+ * @brief   Select telemetry content & decimation.
+ * @param   mask        is the content control bits , TELEM_XXX , 0 = stop.
+ * @param   decimation  is the output frames between 2 telemetry frames , 0 / 1 = every frame.
+ */
+extern void App_Telem_config(uint8_t mask, uint8_t decimation);
+
+/*!@fn      App_Telem_setTiming
+ * @brief   Record 1 timing value of current frame.
+ * @param   index   is TELEM_TIMING_XXX.
+ * @param   ticks   is the time , unit in Clock_getTick() ticks.
+ */
+extern void App_Telem_setTiming(uint8_t index, uint32_t ticks);
+
+/*!@fn      App_Telem_service
+ * @brief   Send deferred log records , call in main loop.
+ */
+extern void App_Telem_service(void);
+
+/*!@fn      App_Telem_frame
+ * @brief   Call once per output frame after duty is sent , packets are queued to UART every decimation frames.
+ */
+extern void App_Telem_frame(void);
+
+#endif /* APP_APP_TELEM_H_ */
@@ -45,7 +45,7 @@
 #define MCLK_F_16M8         (16777216)
 #define MCLK_F              MCLK_F_16M8         //MCLK for CPU
 
-#define SMCLK_DIV_BIT       2
+#define SMCLK_DIV_BIT       0                   //SMCLK = MCLK , UART up to 921600 within 5% bit error
 #define SMCLK_F             (MCLK_F>>SMCLK_DIV_BIT) //SMCLK for UART/I2C/SPI
 
 #define ACLK_F_32K          REFO_F
@@ -62,9 +62,31 @@
 
 #define SPI_MASTER_CLK      1000000
 #define UART_BAUDRATE       115200
-#define I2C_MASTER_CLK      100000
+#define I2C_MASTER_CLK      400000              //Up to I2C_M_CLK_MAX
 #define I2C_SLAVE_ADDRESS   0x48
 
+/******************************************************************************
+ * SPI slave CS edge interrupt.
+ * STE (P3.2) has no port interrupt , it is also wired to P1.2 for frame end detection.
+ *****************************************************************************/
+#define SPI_S_CS_IRQ_DIR    P1DIR
+#define SPI_S_CS_IRQ_IES    P1IES
+#define SPI_S_CS_IRQ_IE     P1IE
+#define SPI_S_CS_IRQ_IFG    P1IFG
+#define SPI_S_CS_IRQ_VECTOR PORT1_VECTOR
+#define SPI_S_CS_IRQ_PIN    BIT2
+
+/******************************************************************************
+ * SPI master CS define.
+ * CS_0~CS7 = P6.0~P6.7 , CS_8~CS15 = P7.0~P7.7 , active low.
+ *****************************************************************************/
+#define SPI_M_CS_GRP_L      P6OUT
+#define SPI_M_CS_DIR_L      P6DIR
+#define SPI_M_CS_PIN_L      0xFF
+#define SPI_M_CS_GRP_H      P7OUT
+#define SPI_M_CS_DIR_H      P7DIR
+#define SPI_M_CS_PIN_H      0xFF
+
 /******************************************************************************
  * PWM define.
  *****************************************************************************/
@@ -7,38 +7,312 @@
  */
 #include "iw7027.h"
 #include "hal.h"
+#include "string.h"
 
 /*****************************************************************************
  * Operation Constant Define
  *****************************************************************************/
-#define IW7027_SPIM_CS_TO_DATA_DELAY    100
-#define IW7027_SPIM_DATA_TO_CS_DELAY    100
+#define IW7027_SPIM_CS_TO_DATA_DELAY    100     //Default CS setup time , counted by SPI master CS sequencer.
+#define IW7027_SPIM_DATA_TO_CS_DELAY    100     //Default CS hold time , counted by SPI master CS sequencer.
 #define IW7027_SPIM_MAX_BUF_SIZE        256
 #define IW7027_SPIM_READ_CHECK_RETRY    10
 #define IW7027_SPIM_READ_CHECK_DELAY    100
 
 #define IW7027_PWM_OUT_CH               1
+#define IW7027_VSYNC_DUTY               128     //[x/256] VSYNC_OUT duty.
+
+/* Frame frequency , only VSYNC_OUT period is switched , IW7027 follows VSYNC.
+ * No frequency / multiplier register of IW7027 is known from datasheet , PWM cycles per frame stays 1.
+ */
+#define IW7027_FREQ_SYNC_TIMEOUT_US     50000   //More than 2 periods of 50Hz.
+
+/* Initialize sequencer , every wait is a polled condition with deadline.
+ * Reset finish : all chip IDs readable. VSYNC lock : VSYNC_OUT periods sent.
+ */
+#define IW7027_CHIP_ID_REG              0xEB
+#define IW7027_CHIP_ID                  0x24
+#define IW7027_INIT_RESET_TIMEOUT_MS    100     //Reset to chip ID readable.
+#define IW7027_INIT_ID_POLL_US          500     //Interval between 2 chip ID rounds.
+#define IW7027_INIT_LOCK_FRAMES         3       //VSYNC_OUT periods for IW7027 to lock.
+#define IW7027_INIT_LOCK_TIMEOUT_MS     100
+
+/* Shadow register cache.
+ * 0x00 (control , reset) & 0x40~0x5F (duty , cached by duty shadow) are always written.
+ */
+#define IW7027_IS_CACHED(reg)           (((reg) != 0x00) && (((reg) < 0x40) || ((reg) >= 0x60)))
+#define IW7027_BIT_GET(map, n)          ((map)[(n) >> 3] & (1 << ((n) & 0x07)))
+#define IW7027_BIT_SET(map, n)          ((map)[(n) >> 3] |= (1 << ((n) & 0x07)))
+#define IW7027_BIT_CLR(map, n)          ((map)[(n) >> 3] &= ~(1 << ((n) & 0x07)))
+
+#ifndef SPI_MASTER_CLK
+#define SPI_MASTER_CLK                  1000000
+#endif
+
+/* SPI frame head : BIT7~6 = operation , BIT5~0 = chip ID.
+ * Reference : <Dialog TV BL driver_SPI_Interface.pdf> P10 <3.1. Write Single Data>
+ * Parallel mode heads 0xC0 / 0x01 / 0x41 are the same layout with chip ID 0 or 1.
+ * Not verified : daisy-chain framing below (op / ID head , read turnaround , chain delay) is derived from
+ * the parallel mode heads , not from a daisy-chain timing diagram , and never tested on a chain.
+ */
+#define IW7027_OP_WRITE_SINGLE          0xC0
+#define IW7027_OP_WRITE                 0x00
+#define IW7027_OP_READ                  0x40
+#define IW7027_ID_BROADCAST             0x00
+#define IW7027_ID(dev)                  ((dev) + 1)         //Chip ID of device index , in daisy-chain order.
+#define IW7027_HEAD(op, id)             ((op) | ((id) & 0x3F))
+#define IW7027_READ_TURNAROUND          2                   //Not verified. Dummy bytes between read command and data.
+
+//Daisy-chain : all devices share CS of the 1st device , every device delays data by 1 byte (Not verified).
+#define IW7027_CHAIN_CS                 IW_SEL_0
+#define IW7027_CHAIN_DELAY_PER_DEV      1                   //Not verified.
+#define IW7027_CHAIN_READ_DELAY         ((Iw7027_DevAmount - 1) * IW7027_CHAIN_DELAY_PER_DEV)
+#define IW7027_CHAIN_READ_DELAY_MAX     ((IW7027_DEV_MAX - 1) * IW7027_CHAIN_DELAY_PER_DEV)
+#define IW7027_IS_BROADCAST(sel)        (((sel) & Iw7027_SelAll) == Iw7027_SelAll)
+
+//Duty write of 1 device , plus CS setup & hold delay in parallel mode.
+#if IW7027_DAISY_CHAIN
+#define IW7027_DUTY_US_PER_DEV          (IW7027_DUTY_BYTE_PER_DEV * 8000000UL / SPI_MASTER_CLK)
+#else
+#define IW7027_DUTY_US_PER_DEV          (IW7027_SPIM_CS_TO_DATA_DELAY + IW7027_SPIM_DATA_TO_CS_DELAY \
+                                        + IW7027_DUTY_BYTE_PER_DEV * 8000000UL / SPI_MASTER_CLK)
+#endif
+
+/*****************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+static uint8_t Iw7027_DevAmount = IW7027_DEV_DEFAULT;
+static uint16_t Iw7027_SelAll = (1 << IW7027_DEV_DEFAULT) - 1;                  //Select bits of all devices.
+static uint16_t Iw7027_CsMap[IW7027_DEV_MAX] =                                  //CS pins of each device.
+{
+    0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+    0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, 0x8000
+};
+static uint8_t Iw7027_DutyShadow[IW7027_DEV_MAX][IW7027_DUTY_SIZE_PER_DEV];   //Last sent duty of each device.
+static uint8_t Iw7027_DutyRefreshCount = 0;
+static tIw7027_DutyStat Iw7027_DutyStat;
+static tIw7027_Layout Iw7027_Layout;                                            //Channel layout of duty.
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_SECTION(Iw7027_RegShadow, ".usbram")                               //USB not used , save RAM.
+#endif
+static uint8_t Iw7027_RegShadow[IW7027_DEV_MAX][IW7027_SHADOW_SIZE];            //Last written register value.
+static uint8_t Iw7027_RegValid[IW7027_DEV_MAX][IW7027_SHADOW_SIZE / 8];      //Shadow value is the same as device.
+static uint8_t Iw7027_RegDirty[IW7027_DEV_MAX][IW7027_SHADOW_SIZE / 8];      //Shadow value waiting to be written.
+static tIw7027_QueueItem Iw7027_Queue[IW7027_QUEUE_SIZE];    //Register transaction queue.
+static uint8_t Iw7027_QueueHead = 0;        //Next position to add.
+static uint8_t Iw7027_QueueTail = 0;        //Transaction in service.
+static uint8_t Iw7027_QueueDev = 0;         //Device in service of IW_Q_POLL.
+static uint8_t Iw7027_QueueRetry = 0;
+static uint8_t Iw7027_QueueWait = 0;        //Frames to wait before next poll retry.
+static tIw7027_Status Iw7027_Status;        //Status table of background monitor.
+static uint8_t Iw7027_MonDev = 0;           //Device of next scan slice.
+static uint8_t Iw7027_MonWait = 0;
+static tIw7027_FreqStat Iw7027_FreqStat;    //Working frequency & last switch latency.
+static uint8_t Iw7027_FreqReq = 0;          //[Hz] Frequency waiting for VSYNC_OUT period boundary , 0 = none.
+static uint32_t Iw7027_FreqReqTick;         //Clock tick at request.
+static tIw7027_InitStat Iw7027_InitStat;    //Time & result of last initialize.
+#if IW7027_DAISY_CHAIN
+static uint8_t Iw7027_ChainBuf[IW7027_DEV_MAX * IW7027_DUTY_BYTE_PER_DEV];    //Duty frames of whole chain.
+#endif
 
 /*****************************************************************************
  * Internal Functions.
  *****************************************************************************/
 
-#define IW7027_LOG          printf
+#define IW7027_LOG          DLOG
 #define IW7027_DELAY_US     DELAY_US
 #define IW7027_DELAY_MS     DELAY_MS
 
-uint16_t IW_D12P16_TO_D8P8X2(uint16_t *pu16in, uint8_t* pu8out, uint16_t in_size)
+/*!@brief   Compare new duty block with shadow copy , update shadow when changed.
+ * @return  0 : Block is the same as last sent.
+ *          1 : Block changed , shadow is updated.
+ */
+uint8_t Iw7027_updateDutyShadow(uint8_t *shadow, uint8_t *block, uint16_t len)
 {
     uint16_t i;
-    uint16_t j = 0;
-    for (i = 0; i < in_size; i++)
+    uint8_t changed = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (shadow[i] != block[i])
+        {
+            shadow[i] = block[i];
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+/*!@brief   Read 1 register , unlock READ_EXTD when access register address of 0x80~0xFF.
+ *          Reference: <iW7037 SPI Mode Application Notes V01.pdf> Page30 <How to read the status registers from [0x80] to [0xFF]>
+ */
+uint8_t Iw7027_readReg(uint16_t iw_sel, uint8_t reg)
+{
+    uint8_t val;
+
+    if (reg >= 0x80)
+    {
+        Iw7027_putc(iw_sel, 0x78, 0x80);
+    }
+    val = Iw7027_getc(iw_sel, reg);
+    if (reg >= 0x80)
+    {
+        Iw7027_putc(iw_sel, 0x78, 0x00);
+    }
+    return val;
+}
+
+IW7027_RET Iw7027_addQueue(IW7027_QUEUE_OP op, uint16_t iw_sel, uint8_t reg, uint8_t val, uint8_t mask,
+        tIw7027_QueueCallback callback)
+{
+    uint8_t next = (Iw7027_QueueHead + 1) % IW7027_QUEUE_SIZE;
+
+    if (next == Iw7027_QueueTail)
+    {
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : Queue full , op = %x , reg = %x.", __FUNCTION__, op, reg);
+        return IW7027_FAIL;
+    }
+
+    tIw7027_QueueItem *item = &Iw7027_Queue[Iw7027_QueueHead];
+    item->Op = op;
+    item->Sel = iw_sel;
+    item->Reg = reg;
+    item->Val = val;
+    item->Mask = mask;
+    item->Callback = callback;
+    Iw7027_QueueHead = next;
+
+    return IW7027_SUCCESS;
+}
+
+/*!@brief   Remove transaction in service from queue , then report result.*/
+void Iw7027_finishQueue(uint8_t val, IW7027_RET status)
+{
+    tIw7027_QueueItem item = Iw7027_Queue[Iw7027_QueueTail];
+
+    Iw7027_QueueTail = (Iw7027_QueueTail + 1) % IW7027_QUEUE_SIZE;
+    Iw7027_QueueDev = 0;
+    Iw7027_QueueRetry = 0;
+    Iw7027_QueueWait = 0;
+
+    if (item.Callback)
+    {
+        item.Callback(item.Sel, item.Reg, val, status);
+    }
+}
+
+/*!@brief   Find next dirty run of 1 device from [reg] , dirty runs with small gap are merged.
+ *          Only valid registers can be in the gap , they are rewritten with the same value.
+ * @return  Run length , 0 when no dirty register left.
+ */
+uint8_t Iw7027_findDirtyRun(uint8_t dev, uint8_t reg, uint8_t *start)
+{
+    uint8_t end, gap = 0;
+
+    while ((reg < IW7027_SHADOW_SIZE) && !IW7027_BIT_GET(Iw7027_RegDirty[dev], reg))
+    {
+        reg++;
+    }
+    if (reg >= IW7027_SHADOW_SIZE)
+    {
+        return 0;
+    }
+
+    *start = reg;
+    end = reg + 1;
+    for (reg = end; reg < IW7027_SHADOW_SIZE; reg++)
+    {
+        if (IW7027_BIT_GET(Iw7027_RegDirty[dev], reg))
+        {
+            end = reg + 1;
+            gap = 0;
+        }
+        else if ((++gap > IW7027_SHADOW_GAP_MERGE) || !IW7027_BIT_GET(Iw7027_RegValid[dev], reg))
+        {
+            break;
+        }
+    }
+    return end - *start;
+}
+
+/*!@brief   Check whether device [dev] can share the run of device [ref] in 1 burst.*/
+uint8_t Iw7027_isSameRun(uint8_t dev, uint8_t ref, uint8_t start, uint8_t len)
+{
+    uint8_t reg, dirty = 0;
+
+    if (memcmp(&Iw7027_RegShadow[dev][start], &Iw7027_RegShadow[ref][start], len))
+    {
+        return 0;
+    }
+    //Clean registers inside the run must be valid , they are rewritten with the same value.
+    for (reg = start; reg < start + len; reg++)
+    {
+        if (IW7027_BIT_GET(Iw7027_RegDirty[dev], reg))
+        {
+            dirty = 1;
+        }
+        else if (!IW7027_BIT_GET(Iw7027_RegValid[dev], reg))
+        {
+            return 0;
+        }
+    }
+    return dirty;
+}
+
+/*!@brief   Scan status registers of 1 device every IW7027_MON_INTERVAL frames.*/
+void Iw7027_scanMonitor(void)
+{
+    if ((Iw7027_Status.Enable == 0) || (++Iw7027_MonWait < IW7027_MON_INTERVAL))
+    {
+        return;
+    }
+    Iw7027_MonWait = 0;
+
+    Iw7027_gets(IW_SEL(Iw7027_MonDev), IW7027_MON_BASE, IW7027_MON_SIZE, Iw7027_Status.Reg[Iw7027_MonDev]);
+    Iw7027_Status.ScanCount[Iw7027_MonDev]++;
+    if ((Iw7027_Status.Reg[Iw7027_MonDev][0] & IW7027_MON_STATE_MASK) != IW7027_MON_STATE_OK)
+    {
+        Iw7027_Status.Fault |= IW_SEL(Iw7027_MonDev);
+    }
+    else
+    {
+        Iw7027_Status.Fault &= ~IW_SEL(Iw7027_MonDev);
+    }
+
+    if (++Iw7027_MonDev >= Iw7027_DevAmount)
+    {
+        Iw7027_MonDev = 0;
+    }
+}
+
+void Iw7027_setCurrentCallback(uint16_t iw_sel, uint8_t reg, uint8_t val, IW7027_RET status)
+{
+    if (status == IW7027_FAIL)
     {
-        // 0x0ABC -> 0x0A , 0xBC
-        pu8out[j++] = (pu16in[i] & 0x0F00) >> 8;
-        pu8out[j++] = (pu16in[i]) & 0xFF;
+        IW7027_LOG("\r\nERROR : IW7027 Set Current Fail , [%x] = %x.", reg, val);
     }
+}
 
-    return j;
+/*!@brief   Fused pack & permute of 1 device , write its 32 byte block in channel order.
+ *          0x0ABC -> 0x0A , 0xBC , channels not in layout = 0.
+ */
+void Iw7027_packDevice(uint16_t *duty, uint8_t dev, uint8_t *block)
+{
+    tIw7027_LayoutRun *run = &Iw7027_Layout.Run[Iw7027_Layout.DevRun[dev]];
+    tIw7027_LayoutRun *end = &Iw7027_Layout.Run[Iw7027_Layout.DevRun[dev + 1]];
+
+    memset(block, 0x00, IW7027_DUTY_SIZE_PER_DEV);
+    for (; run < end; run++)
+    {
+        uint16_t *src = &duty[run->Src];
+        uint8_t *dst = &block[run->Dst * 2];
+        uint8_t len = run->Len;
+
+        while (len--)
+        {
+            *dst++ = (*src >> 8) & 0x0F;
+            *dst++ = *src++ & 0xFF;
+        }
+    }
 }
 
 void IwSpiMaster_putc(uint8_t c)
@@ -61,23 +335,162 @@ void IwSpiMaster_gets(uint8_t *s, uint16_t len)
     SpiMaster_gets(s, len);
 }
 
-void IwSpiMaster_setCsPins(uint16_t cs)
+/*!@brief   CS pins of selected devices.*/
+uint16_t IwSpiMaster_getCs(uint16_t iw_sel)
 {
-    if (cs)
+    uint16_t cs = 0;
+    uint8_t i;
+
+    for (i = 0; iw_sel && (i < Iw7027_DevAmount); i++, iw_sel >>= 1)
     {
-        SpiMaster_setCsPins(cs);
-        IW7027_DELAY_US(IW7027_SPIM_CS_TO_DATA_DELAY);
+        if (iw_sel & 0x01)
+        {
+            cs |= Iw7027_CsMap[i];
+        }
     }
-    else
+    return cs;
+}
+
+/*!@brief   Set CS pins of selected devices active , 0 = release all.
+ *          CS setup / hold time of each device is waited by SPI master.
+ */
+void IwSpiMaster_setCsPins(uint16_t iw_sel)
+{
+    SpiMaster_setCsPins(IwSpiMaster_getCs(iw_sel));
+}
+
+/*!@brief   Queue 1 write transfer to selected devices , returns before CS released.
+ *          Head is copied , data must stay unchanged until IwSpiMaster_flush().
+ */
+void IwSpiMaster_putsAsync(uint16_t iw_sel, uint8_t *head, uint8_t head_len, uint8_t *s, uint16_t len)
+{
+    SpiMaster_putsAsync(IwSpiMaster_getCs(iw_sel), head, head_len, s, len);
+}
+
+/*!@brief   Queue 1 read transfer to selected devices , last received byte stored to *last.
+ *          *last is valid after IwSpiMaster_flush().
+ */
+void IwSpiMaster_getcAsync(uint16_t iw_sel, uint8_t *head, uint8_t head_len, const uint8_t *s, uint16_t len,
+                           uint8_t *last)
+{
+    SpiMaster_getcAsync(IwSpiMaster_getCs(iw_sel), head, head_len, s, len, last);
+}
+
+void IwSpiMaster_flush(void)
+{
+    SpiMaster_flush();
+}
+
+/*!@brief   Read chip ID of all selected devices in 1 round.
+ *          READ_EXTD is unlocked & locked for all devices in 1 transaction.
+ *          Parallel mode : devices share MISO , so each ID read has its own CS window ,
+ *          all reads are queued back to back & waited once.
+ * @return  Devices whose chip ID does not match.
+ */
+uint16_t Iw7027_checkIdRound(uint16_t iw_sel)
+{
+    uint8_t i;
+    uint16_t fail = iw_sel;
+
+#if IW7027_DAISY_CHAIN
+    Iw7027_putc(iw_sel, 0x78, 0x80);
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        if ((iw_sel & IW_SEL(i)) && (Iw7027_getc(IW_SEL(i), IW7027_CHIP_ID_REG) == IW7027_CHIP_ID))
+        {
+            fail &= ~IW_SEL(i);
+        }
+    }
+    Iw7027_putc(iw_sel, 0x78, 0x00);
+#else
+    static const uint8_t dummy[3] = {0x00, 0x00, 0x00};
+    uint8_t head[2] = {0x41, IW7027_CHIP_ID_REG | 0x80};
+    uint8_t id[IW7027_DEV_MAX];
+
+    // Unlock , read IDs , lock , all queued. Head is copied.
+    Iw7027_putc(iw_sel, 0x78, 0x80);
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        id[i] = 0;
+        if (iw_sel & IW_SEL(i))
+        {
+            IwSpiMaster_getcAsync(IW_SEL(i), head, 2, dummy, 3, &id[i]);
+        }
+    }
+    Iw7027_putc(iw_sel, 0x78, 0x00);
+    IwSpiMaster_flush();
+
+    for (i = 0; i < Iw7027_DevAmount; i++)
     {
-        IW7027_DELAY_US(IW7027_SPIM_DATA_TO_CS_DELAY);
-        SpiMaster_setCsPins(cs);
+        if ((iw_sel & IW_SEL(i)) && (id[i] == IW7027_CHIP_ID))
+        {
+            fail &= ~IW_SEL(i);
+        }
+    }
+#endif
+    return fail;
+}
+
+/*!@brief   Get device index of the 1st selected device.
+ * @return  Device index , Iw7027_DevAmount when no device selected.
+ */
+uint8_t Iw7027_getFirstDev(uint16_t iw_sel)
+{
+    uint8_t i;
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        if (iw_sel & IW_SEL(i))
+        {
+            break;
+        }
     }
+    return i;
 }
 
 void IwVsyncOut_setOutput(uint16_t freq, uint16_t duty)
 {
-    PwmOut_setOutput(IW7027_PWM_OUT_CH, freq, duty * 256 / 100);
+    PwmOut_setOutput(IW7027_PWM_OUT_CH, freq, duty);
+
+    //Working frequency is lost with VSYNC_OUT off , next Iw7027_setFreq() must switch again.
+    if (freq == 0)
+    {
+        Iw7027_FreqReq = 0;
+        Iw7027_FreqStat.Freq = 0;
+    }
+}
+
+/*!@brief   Finish frequency switch requested by Iw7027_setFreq() after VSYNC_OUT switched period ,
+ *          switch latency is measured to the frame it is serviced.
+ */
+void Iw7027_serviceFreq(void)
+{
+    uint32_t wait;
+
+    if (Iw7027_FreqReq == 0)
+    {
+        return;
+    }
+
+    wait = CLOCK_TICK_TO_US(Clock_getTick() - Iw7027_FreqReqTick);
+    if (PwmOut_isSyncPending())
+    {
+        if (wait < IW7027_FREQ_SYNC_TIMEOUT_US)
+        {
+            return;
+        }
+        //PWM timer interrupt not working , VSYNC_OUT is still at the old period.
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : VSYNC_OUT period boundary timeout.", __FUNCTION__);
+        Iw7027_FreqStat.TimeoutCount++;
+        Iw7027_FreqReq = 0;
+        return;
+    }
+
+    Iw7027_FreqStat.Freq = Iw7027_FreqReq;
+    Iw7027_FreqStat.SwitchCount++;
+    Iw7027_FreqStat.WaitUs = wait;
+    Iw7027_FreqReq = 0;
+
+    IW7027_LOG("\r\nIW7027 Freq = %dHz , wait = %dus", Iw7027_FreqStat.Freq, Iw7027_FreqStat.WaitUs);
 }
 
 /*****************************************************************************
@@ -87,11 +500,33 @@ void IwVsyncOut_setOutput(uint16_t freq, uint16_t duty)
 void Iw7027_putc(uint16_t iw_sel, uint8_t reg, uint8_t u8data)
 {
 #if IW7027_DAISY_CHAIN  //Daisy-Chain Mode SPI
+    /* All selected devices are written in 1 CS window.
+     * Broadcast when all devices are selected , otherwise 1 frame with chip ID for each device.
+     * */
+    uint8_t spi_buf[3];
+    uint16_t i;
+    spi_buf[1] = reg;
+    spi_buf[2] = u8data;
 
+    IwSpiMaster_setCsPins(IW7027_CHAIN_CS);
+    if (IW7027_IS_BROADCAST(iw_sel))
+    {
+        spi_buf[0] = IW7027_HEAD(IW7027_OP_WRITE_SINGLE, IW7027_ID_BROADCAST);
+        IwSpiMaster_puts(spi_buf, 3);
+    }
+    else
+    {
+        for (i = 0; i < Iw7027_DevAmount; i++)
+        {
+            if (iw_sel & IW_SEL(i))
+            {
+                spi_buf[0] = IW7027_HEAD(IW7027_OP_WRITE_SINGLE, IW7027_ID(i));
+                IwSpiMaster_puts(spi_buf, 3);
+            }
+        }
+    }
+    IwSpiMaster_setCsPins(0x00);
 #else //Parallel Mode SPI
-    //Set CS pins.
-    IwSpiMaster_setCsPins(iw_sel);
-
     /* Prepare SPI transmit buffer.
      * Reference : <Dialog TV BL driver_SPI_Interface.pdf> P10 <3.1. Write Single Data>
      * */
@@ -100,18 +535,34 @@ void Iw7027_putc(uint16_t iw_sel, uint8_t reg, uint8_t u8data)
     spi_buf[1] = reg;
     spi_buf[2] = u8data;
 
-    // SPI Transmit
-    IwSpiMaster_puts(spi_buf, 3);
-
-    //Reset CS pins.
-    IwSpiMaster_setCsPins(0x00);
+    // SPI Transmit , CS & timing by SPI master CS sequencer. Buffer is copied.
+    IwSpiMaster_putsAsync(iw_sel, spi_buf, 3, 0, 0);
 #endif
 }
 
 uint8_t Iw7027_getc(uint16_t iw_sel, uint8_t reg)
 {
 #if IW7027_DAISY_CHAIN  //Daisy-Chain Mode SPI
+    /* Read from the 1st selected device.
+     * Read data passes through the rest of chain , arrives after IW7027_CHAIN_READ_DELAY more bytes.
+     * */
+    uint8_t dev = Iw7027_getFirstDev(iw_sel);
+    if (dev >= Iw7027_DevAmount)
+    {
+        return 0;
+    }
+
+    uint8_t spi_buf[2 + IW7027_READ_TURNAROUND + IW7027_CHAIN_READ_DELAY_MAX + 1];
+    memset(spi_buf, 0x00, sizeof(spi_buf));
+    spi_buf[0] = IW7027_HEAD(IW7027_OP_READ, IW7027_ID(dev));
+    spi_buf[1] = reg | 0x80;
+
+    IwSpiMaster_setCsPins(IW7027_CHAIN_CS);
+    IwSpiMaster_puts(spi_buf, 2 + IW7027_READ_TURNAROUND + IW7027_CHAIN_READ_DELAY + 1);
+    uint8_t ret = IwSpiMaster_getc();
+    IwSpiMaster_setCsPins(0x00);
 
+    return ret;
 #else //Parallel Mode SPI
     //Set CS pins.
     IwSpiMaster_setCsPins(iw_sel);
@@ -137,14 +588,43 @@ uint8_t Iw7027_getc(uint16_t iw_sel, uint8_t reg)
 #endif
 }
 
-IW7027_RET Iw7027_puts(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data)
+/*!@brief   Burst write , returns before transfer finishes in parallel mode.
+ *          Data must stay unchanged until IwSpiMaster_flush() , for driver buffers (shadow) only.
+ */
+IW7027_RET Iw7027_putsAsync(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data)
 {
 #if IW7027_DAISY_CHAIN  //Daisy-Chain Mode SPI
+    /* All selected devices are written in 1 CS window.
+     * Broadcast when all devices are selected , otherwise 1 frame with chip ID for each device.
+     * */
+    uint8_t spi_head[3];
+    uint16_t i;
+    spi_head[1] = len;
+    spi_head[2] = reg;
 
-#else //Parallel Mode SPI
-    //Set CS pins.
-    IwSpiMaster_setCsPins(iw_sel);
+    IwSpiMaster_setCsPins(IW7027_CHAIN_CS);
+    if (IW7027_IS_BROADCAST(iw_sel))
+    {
+        spi_head[0] = IW7027_HEAD(IW7027_OP_WRITE, IW7027_ID_BROADCAST);
+        IwSpiMaster_puts(spi_head, 3);
+        IwSpiMaster_puts(pu8data, len);
+    }
+    else
+    {
+        for (i = 0; i < Iw7027_DevAmount; i++)
+        {
+            if (iw_sel & IW_SEL(i))
+            {
+                spi_head[0] = IW7027_HEAD(IW7027_OP_WRITE, IW7027_ID(i));
+                IwSpiMaster_puts(spi_head, 3);
+                IwSpiMaster_puts(pu8data, len);
+            }
+        }
+    }
+    IwSpiMaster_setCsPins(0x00);
 
+    return IW7027_SUCCESS;
+#else //Parallel Mode SPI
     /* Prepare SPI transmit buffer.
      * Reference : <Dialog TV BL driver_SPI_Interface.pdf> P10 <3.1. Write Single Data>
      * */
@@ -153,40 +633,66 @@ IW7027_RET Iw7027_puts(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8da
     spi_head[1] = len;
     spi_head[2] = reg;
 
-    // SPI Transmit Head + Data
-    IwSpiMaster_puts(spi_head, 3);
-    IwSpiMaster_puts(pu8data, len);
-
-    //Reset CS pins.
-    IwSpiMaster_setCsPins(0x00);
+    // SPI Transmit Head + Data , CS & timing by SPI master CS sequencer.
+    IwSpiMaster_putsAsync(iw_sel, spi_head, 3, pu8data, len);
 
     return IW7027_SUCCESS;
 #endif
 }
 
+IW7027_RET Iw7027_puts(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data)
+{
+    //Caller's buffer may change after return , wait transfer finish.
+    IW7027_RET ret = Iw7027_putsAsync(iw_sel, reg, len, pu8data);
+    IwSpiMaster_flush();
+    return ret;
+}
+
 IW7027_RET Iw7027_gets(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data)
 {
-#if IW7027_DAISY_CHAIN  //Daisy-Chain Mode SPI
+    //Read continuous registers of the 1st selected device.
+    uint8_t dev = Iw7027_getFirstDev(iw_sel);
+    if ((dev >= Iw7027_DevAmount) || (len == 0) || (pu8data == 0))
+    {
+        return IW7027_FAIL;
+    }
 
-#else //Parallel Mode SPI
+    //Special operation when access register address of 0x80~0xFF
+    //Reference: <iW7037 SPI Mode Application Notes V01.pdf> Page30 <How to read the status registers from [0x80] to [0xFF]>
+    //Unlock READ_EXTD.
+    if (reg >= 0x80)
+    {
+        Iw7027_putc(IW_SEL(dev), 0x78, 0x80);
+    }
 
-    //Not Available YET
+    /* Only the single read frame (head , address , dummy bytes) is documented ,
+     * reference : <Dialog TV BL driver_SPI_Interface.pdf> P10. Registers are read 1 by 1 with it.
+     * */
+    uint8_t i;
+    for (i = 0; i < len; i++)
+    {
+        pu8data[i] = Iw7027_getc(IW_SEL(dev), reg + i);
+    }
 
-    return IW7027_FAIL;
-#endif
+    //Lock READ_EXTD when finish.
+    if (reg >= 0x80)
+    {
+        Iw7027_putc(IW_SEL(dev), 0x78, 0x00);
+    }
+
+    return IW7027_SUCCESS;
 }
 
 IW7027_RET Iw7027_checkGetWithTimeOut(uint16_t iw_sel, uint8_t reg, uint8_t compare_val, uint8_t compare_mask)
 {
-    uint8_t chipcount;
     uint8_t retrycount;
     uint8_t status;
     uint8_t val;
 
     uint16_t i;
-    for (i = 0; i < IW7027_DEV_AMOUNT; i++) // Check from IW_0 to IW_N
+    for (i = 0; i < Iw7027_DevAmount; i++) // Check from IW_0 to IW_N
     {
-        if (iw_sel & IW_SEL_LIST[i]) //Only check selected device.
+        if (iw_sel & IW_SEL(i)) //Only check selected device.
         {
             retrycount = IW7027_SPIM_READ_CHECK_RETRY;
             status = 0x01;
@@ -196,13 +702,13 @@ IW7027_RET Iw7027_checkGetWithTimeOut(uint16_t iw_sel, uint8_t reg, uint8_t comp
             //Unlock READ_EXTD.
             if (reg >= 0x80)
             {
-                Iw7027_putc((iw_sel & chipcount), 0x78, 0x80);
+                Iw7027_putc(IW_SEL(i), 0x78, 0x80);
             }
 
             //Read & check result with retry.
             while (--retrycount && status)
             {
-                val = Iw7027_getc((iw_sel & chipcount), reg);
+                val = Iw7027_getc(IW_SEL(i), reg);
 
                 if ((val & compare_mask) == compare_val)
                 {
@@ -219,7 +725,7 @@ IW7027_RET Iw7027_checkGetWithTimeOut(uint16_t iw_sel, uint8_t reg, uint8_t comp
             //Lock READ_EXTD when finish.
             if (reg >= 0x80)
             {
-                Iw7027_putc((iw_sel & chipcount), 0x78, 0x00);
+                Iw7027_putc(IW_SEL(i), 0x78, 0x00);
             }
             if (retrycount == 0)
             {
@@ -235,96 +741,633 @@ IW7027_RET Iw7027_checkGetWithTimeOut(uint16_t iw_sel, uint8_t reg, uint8_t comp
 
 IW7027_RET Iw7027_init(uint8_t bon, uint8_t *init_map)
 {
+    uint32_t start = Clock_getTick();
+    uint32_t step;
+
     IW7027_LOG("\r\nIW7027 Initial Start , Operation code = %x", bon);
 
     if (bon)
     {
+        memset(&Iw7027_InitStat, 0x00, sizeof(Iw7027_InitStat));
+
         //STEP 1 : Force Reset all IW7027 devices.
         IwVsyncOut_setOutput(0, 0);              //Disable VSYNC OUT.
         Iw7027_putc(IW_SEL_ALL, 0x00, 0x00);     //Reset IW7027
-        IW7027_DELAY_MS(100);
+        Iw7027_invalidateReg(IW_SEL_ALL);        //Registers back to default , shadow is unknown.
 
-        //STEP 2 : Read IW7027 Chip ID.
-        //        This step is optional.
-        if (IW7027_FAIL == Iw7027_checkGetWithTimeOut(IW_SEL_ALL, 0xEB, 0x24, 0xFF))
+        //STEP 2 : Wait for reset finish , all chip IDs are read in each round until all match.
+        uint16_t pending = Iw7027_SelAll;
+        step = Clock_getTick();
+        while (1)
         {
-            IW7027_LOG("\r\nERROR : IW7027 Chip ID Check Fail!!!");
+            pending = Iw7027_checkIdRound(pending);
+            Iw7027_InitStat.IdRound++;
+            if ((pending == 0) || (Clock_getTick() - step >= CLOCK_MS_TO_TICK(IW7027_INIT_RESET_TIMEOUT_MS)))
+            {
+                break;
+            }
+            //Poll interval on tick , no cycle delay.
+            uint32_t poll = Clock_getTick();
+            while (Clock_getTick() - poll < CLOCK_US_TO_TICK(IW7027_INIT_ID_POLL_US))
+            {
+                ;
+            }
+        }
+        Iw7027_InitStat.ResetUs = CLOCK_TICK_TO_US(Clock_getTick() - step);
+        Iw7027_InitStat.IdFail = pending;
+        if (pending)
+        {
+            IW7027_LOG("\r\nERROR : IW7027 Chip ID Check Fail!!! Device = %x", pending);
         }
 
         //STEP 3 : Write Initialize Table.
         if (init_map)
         {
-            uint16_t i;
-            for (i = 0; i < IW7027_DEV_AMOUNT; i++)
+            /* Table of IW_0 is broadcast to all devices in 1 transaction ,
+             * then only registers different from IW_0 are staged for each device ,
+             * the same differences of devices are still written together.
+             */
+            uint8_t i, j;
+            step = Clock_getTick();
+            Iw7027_stageReg(IW_SEL_ALL, 0x00, IW7027_INIT_TABLE_SIZE, init_map);
+            Iw7027_InitStat.TableWrite = Iw7027_flushReg(IW_SEL_ALL);
+            for (i = 1; i < Iw7027_DevAmount; i++)
             {
-                Iw7027_puts(IW_SEL_LIST[i], 0x00, 0x60, &init_map[0x60 * i]);
+                uint8_t *table = &init_map[IW7027_INIT_TABLE_SIZE * i];
+                for (j = 0; j < IW7027_INIT_TABLE_SIZE; j++)
+                {
+                    if (table[j] != init_map[j])
+                    {
+                        Iw7027_stageReg(IW_SEL(i), j, 1, &table[j]);
+                    }
+                }
             }
+            Iw7027_InitStat.TableWrite += Iw7027_flushReg(IW_SEL_ALL);
+            IwSpiMaster_flush();
+            Iw7027_InitStat.TableUs = CLOCK_TICK_TO_US(Clock_getTick() - step);
         }
 
-        //STEP 4 : Turn on VSYNC & set working frequency.
-        IwVsyncOut_setOutput(60, 50);
-        IW7027_DELAY_MS(100);
+        //STEP 4 : Set working frequency & turn on VSYNC , wait for IW7027 locking to VSYNC.
+        step = Clock_getTick();
         Iw7027_setFreq(60, 1);
+        uint16_t period = PwmOut_getPeriodCount();
+        while ((uint16_t) (PwmOut_getPeriodCount() - period) < IW7027_INIT_LOCK_FRAMES)
+        {
+            Iw7027_serviceFreq();
+            if (Clock_getTick() - step >= CLOCK_MS_TO_TICK(IW7027_INIT_LOCK_TIMEOUT_MS))
+            {
+                IW7027_LOG("\r\nERROR : IW7027 VSYNC lock timeout.");
+                break;
+            }
+        }
+        Iw7027_InitStat.LockUs = CLOCK_TICK_TO_US(Clock_getTick() - step);
 
         //STEP 5 : Initialize finish ,turn on BL.
         Iw7027_putc(IW_SEL_ALL, 0x00, 0x05);
+
+        //Duty registers are overwritten by reset & initialize table , re-send all at next frame.
+        Iw7027_forceDutyRefresh();
+
+        //Start background status monitor.
+        Iw7027_setMonitor(1);
     }
     else
     {
+        Iw7027_setMonitor(0);
         Iw7027_putc(IW_SEL_ALL, 0x00, 0x00);     //Reset IW7027
     }
 
-    IW7027_LOG("\r\nIW7027 Initial Finish , Operation code = %x", bon);
+    Iw7027_InitStat.TotalUs = CLOCK_TICK_TO_US(Clock_getTick() - start);
+    IW7027_LOG("\r\nIW7027 Initial Finish , Operation code = %x , time = %lu us", bon, Iw7027_InitStat.TotalUs);
+    return IW7027_SUCCESS;
+}
+
+tIw7027_InitStat *Iw7027_getInitStat(void)
+{
+    return &Iw7027_InitStat;
+}
+
+IW7027_RET Iw7027_setDevice(uint8_t dev_amount, const uint16_t *cs_map)
+{
+    uint8_t i;
+
+    if ((dev_amount == 0) || (dev_amount > IW7027_DEV_MAX))
+    {
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : dev_amount = %d , not supported.", __FUNCTION__, dev_amount);
+        return IW7027_FAIL;
+    }
+
+    Iw7027_DevAmount = dev_amount;
+    Iw7027_SelAll = (dev_amount >= 16) ? 0xFFFF : (1 << dev_amount) - 1;
+    for (i = 0; i < dev_amount; i++)
+    {
+        Iw7027_CsMap[i] = cs_map ? cs_map[i] : (1 << i);
+        SpiMaster_setCsTiming(Iw7027_CsMap[i], IW7027_SPIM_CS_TO_DATA_DELAY, IW7027_SPIM_DATA_TO_CS_DELAY);
+    }
+
+    //Layout , shadow & monitor depend on device amount.
+    Iw7027_Layout.ChAmount = 0;
+    Iw7027_invalidateReg(IW_SEL_ALL);
+    Iw7027_forceDutyRefresh();
+    Iw7027_setMonitor(Iw7027_Status.Enable);
+
     return IW7027_SUCCESS;
 }
 
-IW7027_RET Iw7027_setDuty(uint16_t *duty, uint8_t *sort_map)
+uint8_t Iw7027_getDevAmount(void)
+{
+    return Iw7027_DevAmount;
+}
+
+IW7027_RET Iw7027_setCsTiming(uint16_t iw_sel, uint16_t setup_us, uint16_t hold_us)
 {
+    uint16_t cs = IwSpiMaster_getCs(iw_sel);
+    if (cs == 0)
+    {
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : iw_sel = %x , no device selected.", __FUNCTION__, iw_sel);
+        return IW7027_FAIL;
+    }
+    SpiMaster_setCsTiming(cs, setup_us, hold_us);
+    return IW7027_SUCCESS;
+}
+
+IW7027_RET Iw7027_setLayout(const uint8_t *sort_map, uint8_t ch_amount)
+{
+    uint8_t src_of[IW7027_DEV_MAX * IW7027_CH_PER_DEV];     //Duty index of each channel , 0xFF = not used.
     uint16_t i;
-    uint8_t spi_buf[32 * IW7027_DEV_AMOUNT];
 
-    // Prepare SPI send data.
-    if (sort_map == 0)
+    if (ch_amount > Iw7027_DevAmount * IW7027_CH_PER_DEV)
     {
-        //No need sorting when sort map = NULL , do data convert only.
-        IW_D12P16_TO_D8P8X2(duty, spi_buf, IW_CH_AMOUNT);
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : ch_amount = %d , more than channels of devices.", __FUNCTION__, ch_amount);
+        return IW7027_FAIL;
     }
-    else
+
+    //Invert sort map , check every channel is used once only.
+    uint16_t ch_total = Iw7027_DevAmount * IW7027_CH_PER_DEV;
+    memset(src_of, 0xFF, sizeof(src_of));
+    for (i = 0; i < ch_amount; i++)
+    {
+        uint8_t ch = sort_map ? sort_map[i] : i;
+
+        if ((ch >= ch_total) || (src_of[ch] != 0xFF))
+        {
+            IW7027_LOG("\r\nFUNC:[%s] ERROR : sort_map[%d] = %d , invalid or duplicated.", __FUNCTION__, i, ch);
+            return IW7027_FAIL;
+        }
+        src_of[ch] = i;
+    }
+
+    //Build runs of each device in channel order , continuous duty index is merged.
+    uint8_t n = 0;
+    for (i = 0; i < ch_total; i++)
     {
-        //Do data convert with re-sorting order of data.
-        for (i = 0; i < IW_CH_AMOUNT; i++)
+        uint8_t ch = i % IW7027_CH_PER_DEV;
+
+        if (ch == 0)
+        {
+            Iw7027_Layout.DevRun[i / IW7027_CH_PER_DEV] = n;
+        }
+        if (src_of[i] == 0xFF)
         {
-            spi_buf[2 * sort_map[i]] = duty[i] >> 8;
-            spi_buf[2 * sort_map[i] + 1] = duty[i] & 0xFF;
+            continue;
         }
+        if ((n > Iw7027_Layout.DevRun[i / IW7027_CH_PER_DEV])
+                && (Iw7027_Layout.Run[n - 1].Dst + Iw7027_Layout.Run[n - 1].Len == ch)
+                && (Iw7027_Layout.Run[n - 1].Src + Iw7027_Layout.Run[n - 1].Len == src_of[i]))
+        {
+            Iw7027_Layout.Run[n - 1].Len++;
+        }
+        else if (n >= IW7027_LAYOUT_RUN_MAX)
+        {
+            IW7027_LOG("\r\nFUNC:[%s] ERROR : More than %d runs.", __FUNCTION__, IW7027_LAYOUT_RUN_MAX);
+            Iw7027_Layout.ChAmount = 0;
+            return IW7027_FAIL;
+        }
+        else
+        {
+            Iw7027_Layout.Run[n].Src = src_of[i];
+            Iw7027_Layout.Run[n].Dst = ch;
+            Iw7027_Layout.Run[n].Len = 1;
+            n++;
+        }
+    }
+    Iw7027_Layout.DevRun[Iw7027_DevAmount] = n;
+    Iw7027_Layout.ChAmount = ch_amount;
+
+    //Unused channels change to 0 , re-send all.
+    Iw7027_forceDutyRefresh();
+
+    return IW7027_SUCCESS;
+}
+
+IW7027_RET Iw7027_setDuty(uint16_t *duty)
+{
+    uint16_t i;
+
+    //Default layout : duty N on channel N.
+    if (Iw7027_Layout.ChAmount == 0)
+    {
+        Iw7027_setLayout(0, IW_CH_AMOUNT);
+    }
+
+    //Force refresh all devices every IW7027_DUTY_REFRESH frames , in case any device lost data.
+    uint8_t refresh = 0;
+    if (++Iw7027_DutyRefreshCount >= IW7027_DUTY_REFRESH)
+    {
+        Iw7027_DutyRefreshCount = 0;
+        refresh = 1;
     }
 
-    // SPI Data sending from IW_0 to IW_N
-    for (i = 0; i < IW7027_DEV_AMOUNT; i++)
+    // SPI Data sending from IW_0 to IW_N , skip devices whose duty is the same as last sent.
+    uint8_t sent = 0;
+#if IW7027_DAISY_CHAIN
+    //Frames of all changed devices are packed in 1 chain buffer , sent in 1 CS window.
+    uint16_t pos = 0;
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        uint8_t *block = &Iw7027_ChainBuf[pos + IW7027_DUTY_HEAD_SIZE];
+
+        Iw7027_packDevice(duty, i, block);
+        if (Iw7027_updateDutyShadow(Iw7027_DutyShadow[i], block, IW7027_DUTY_SIZE_PER_DEV) || refresh)
+        {
+            Iw7027_ChainBuf[pos] = IW7027_HEAD(IW7027_OP_WRITE, IW7027_ID(i));
+            Iw7027_ChainBuf[pos + 1] = IW7027_DUTY_SIZE_PER_DEV;
+            Iw7027_ChainBuf[pos + 2] = 0x40;
+            pos += IW7027_DUTY_BYTE_PER_DEV;
+            sent++;
+        }
+    }
+    if (pos)
+    {
+        IwSpiMaster_setCsPins(IW7027_CHAIN_CS);
+        IwSpiMaster_puts(Iw7027_ChainBuf, pos);
+        IwSpiMaster_setCsPins(0x00);
+    }
+#else
+    /* Each device is queued as soon as its block is packed , sent from shadow (= block) by SPI master ISR ,
+     * packing of next device runs during CS setup / hold of the last.
+     * Shadow is rewritten below , transfers of last frame must be finished.
+     */
+    uint8_t block[IW7027_DUTY_SIZE_PER_DEV];
+    IwSpiMaster_flush();
+    for (i = 0; i < Iw7027_DevAmount; i++)
     {
-        Iw7027_puts(IW_SEL_LIST[i], 0x40, 32, spi_buf + 32 * i);
+        Iw7027_packDevice(duty, i, block);
+        if (Iw7027_updateDutyShadow(Iw7027_DutyShadow[i], block, IW7027_DUTY_SIZE_PER_DEV) || refresh)
+        {
+            Iw7027_putsAsync(IW_SEL(i), 0x40, IW7027_DUTY_SIZE_PER_DEV, Iw7027_DutyShadow[i]);
+            sent++;
+        }
     }
+#endif
+
+    //Update statistics.
+    Iw7027_DutyStat.FrameCount++;
+    Iw7027_DutyStat.DevSent = sent;
+    Iw7027_DutyStat.DevSkipped = Iw7027_DevAmount - sent;
+    Iw7027_DutyStat.ByteSaved = Iw7027_DutyStat.DevSkipped * IW7027_DUTY_BYTE_PER_DEV;
+    Iw7027_DutyStat.UsSaved = Iw7027_DutyStat.DevSkipped * IW7027_DUTY_US_PER_DEV;
+    Iw7027_DutyStat.ByteSavedTotal += Iw7027_DutyStat.ByteSaved;
+
     return IW7027_SUCCESS;
 }
 
+void Iw7027_forceDutyRefresh(void)
+{
+    Iw7027_DutyRefreshCount = IW7027_DUTY_REFRESH;
+}
+
+tIw7027_DutyStat *Iw7027_getDutyStat(void)
+{
+    return &Iw7027_DutyStat;
+}
+
+IW7027_RET Iw7027_queueWrite(uint16_t iw_sel, uint8_t reg, uint8_t u8data, tIw7027_QueueCallback callback)
+{
+    return Iw7027_addQueue(IW_Q_WRITE, iw_sel, reg, u8data, 0xFF, callback);
+}
+
+IW7027_RET Iw7027_queueRead(uint16_t iw_sel, uint8_t reg, tIw7027_QueueCallback callback)
+{
+    return Iw7027_addQueue(IW_Q_READ, iw_sel, reg, 0x00, 0xFF, callback);
+}
+
+IW7027_RET Iw7027_queuePoll(uint16_t iw_sel, uint8_t reg, uint8_t compare_val, uint8_t compare_mask,
+        tIw7027_QueueCallback callback)
+{
+    return Iw7027_addQueue(IW_Q_POLL, iw_sel, reg, compare_val, compare_mask, callback);
+}
+
+uint8_t Iw7027_serviceQueue(uint8_t max_op)
+{
+    uint8_t val;
+
+    //Frequency switch first , latency is measured to this frame.
+    Iw7027_serviceFreq();
+
+    while (max_op && (Iw7027_QueueTail != Iw7027_QueueHead))
+    {
+        tIw7027_QueueItem *item = &Iw7027_Queue[Iw7027_QueueTail];
+
+        switch (item->Op)
+        {
+        case IW_Q_WRITE:
+        {
+            Iw7027_writeReg(item->Sel, item->Reg, 1, &item->Val);
+            max_op--;
+            Iw7027_finishQueue(item->Val, IW7027_SUCCESS);
+            break;
+        }
+        case IW_Q_READ:
+        {
+            //Read from the 1st selected device only.
+            uint8_t dev = Iw7027_getFirstDev(item->Sel);
+            val = (dev < Iw7027_DevAmount) ? Iw7027_readReg(IW_SEL(dev), item->Reg) : 0x00;
+            max_op--;
+            Iw7027_finishQueue(val, IW7027_SUCCESS);
+            break;
+        }
+        case IW_Q_POLL:
+        {
+            //Waiting between retry , transactions behind keep in order.
+            if (Iw7027_QueueWait)
+            {
+                Iw7027_QueueWait--;
+                return Iw7027_getQueueCount();
+            }
+
+            //Skip devices not selected.
+            while ((Iw7027_QueueDev < Iw7027_DevAmount) && !(item->Sel & IW_SEL(Iw7027_QueueDev)))
+            {
+                Iw7027_QueueDev++;
+            }
+            if (Iw7027_QueueDev >= Iw7027_DevAmount)
+            {
+                //All selected devices checked.
+                Iw7027_finishQueue(item->Val, IW7027_SUCCESS);
+                break;
+            }
+
+            val = Iw7027_readReg(IW_SEL(Iw7027_QueueDev), item->Reg);
+            max_op--;
+            if ((val & item->Mask) == item->Val)
+            {
+                Iw7027_QueueDev++;
+                Iw7027_QueueRetry = 0;
+            }
+            else if (++Iw7027_QueueRetry >= IW7027_QUEUE_POLL_RETRY)
+            {
+                Iw7027_finishQueue(val, IW7027_FAIL);
+            }
+            else
+            {
+                Iw7027_QueueWait = IW7027_QUEUE_POLL_INTERVAL;
+            }
+            break;
+        }
+        default:
+        {
+            Iw7027_finishQueue(0x00, IW7027_FAIL);
+            break;
+        }
+        }
+    }
+
+    //Background status monitor uses the spare budget when queue is idle.
+    if (max_op && (Iw7027_QueueTail == Iw7027_QueueHead))
+    {
+        Iw7027_scanMonitor();
+    }
+
+    return Iw7027_getQueueCount();
+}
+
+uint8_t Iw7027_getQueueCount(void)
+{
+    return (Iw7027_QueueHead + IW7027_QUEUE_SIZE - Iw7027_QueueTail) % IW7027_QUEUE_SIZE;
+}
+
+IW7027_RET Iw7027_stageReg(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data)
+{
+    uint16_t i, j;
+
+    //Out of shadow range , write directly.
+    if ((uint16_t) reg + len > IW7027_SHADOW_SIZE)
+    {
+        return Iw7027_puts(iw_sel, reg, len, pu8data);
+    }
+
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        if (!(iw_sel & IW_SEL(i)))
+        {
+            continue;
+        }
+        for (j = 0; j < len; j++)
+        {
+            uint8_t r = reg + j;
+
+            //Skip register when device already holds the same value.
+            if (IW7027_IS_CACHED(r) && IW7027_BIT_GET(Iw7027_RegValid[i], r)
+                    && (Iw7027_RegShadow[i][r] == pu8data[j]))
+            {
+                continue;
+            }
+            Iw7027_RegShadow[i][r] = pu8data[j];
+            IW7027_BIT_SET(Iw7027_RegDirty[i], r);
+        }
+    }
+    return IW7027_SUCCESS;
+}
+
+uint8_t Iw7027_flushReg(uint16_t iw_sel)
+{
+    uint8_t i, j, start, len, reg;
+    uint8_t burst = 0;
+
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        if (!(iw_sel & IW_SEL(i)))
+        {
+            continue;
+        }
+
+        reg = 0;
+        while ((len = Iw7027_findDirtyRun(i, reg, &start)) != 0)
+        {
+            uint16_t sel = IW_SEL(i);
+
+            //Devices with the same run data are written together.
+            for (j = i + 1; j < Iw7027_DevAmount; j++)
+            {
+                if ((iw_sel & IW_SEL(j)) && Iw7027_isSameRun(j, i, start, len))
+                {
+                    sel |= IW_SEL(j);
+                }
+            }
+
+            Iw7027_putsAsync(sel, start, len, &Iw7027_RegShadow[i][start]);
+            burst++;
+
+            for (j = i; j < Iw7027_DevAmount; j++)
+            {
+                if (sel & IW_SEL(j))
+                {
+                    for (reg = start; reg < start + len; reg++)
+                    {
+                        IW7027_BIT_CLR(Iw7027_RegDirty[j], reg);
+                        if (IW7027_IS_CACHED(reg))
+                        {
+                            IW7027_BIT_SET(Iw7027_RegValid[j], reg);
+                        }
+                    }
+                }
+            }
+            reg = start + len;
+        }
+    }
+    return burst;
+}
+
+IW7027_RET Iw7027_writeReg(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data)
+{
+    IW7027_RET ret = Iw7027_stageReg(iw_sel, reg, len, pu8data);
+    Iw7027_flushReg(iw_sel);
+    return ret;
+}
+
+uint8_t Iw7027_checkReg(uint16_t iw_sel, uint8_t reg, uint8_t u8data)
+{
+    uint16_t i;
+
+    if ((reg >= IW7027_SHADOW_SIZE) || !IW7027_IS_CACHED(reg))
+    {
+        return 0;
+    }
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        if ((iw_sel & IW_SEL(i))
+                && (!IW7027_BIT_GET(Iw7027_RegValid[i], reg) || (Iw7027_RegShadow[i][reg] != u8data)))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void Iw7027_invalidateReg(uint16_t iw_sel)
+{
+    uint16_t i;
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        if (iw_sel & IW_SEL(i))
+        {
+            memset(Iw7027_RegValid[i], 0x00, sizeof(Iw7027_RegValid[i]));
+        }
+    }
+}
+
+void Iw7027_resyncReg(uint16_t iw_sel)
+{
+    uint16_t i;
+    for (i = 0; i < Iw7027_DevAmount; i++)
+    {
+        if (iw_sel & IW_SEL(i))
+        {
+            //Rewrite every register known by shadow.
+            uint8_t j;
+            for (j = 0; j < sizeof(Iw7027_RegDirty[i]); j++)
+            {
+                Iw7027_RegDirty[i][j] |= Iw7027_RegValid[i][j];
+            }
+        }
+    }
+    Iw7027_flushReg(iw_sel);
+}
+
+void Iw7027_setMonitor(uint8_t enable)
+{
+    Iw7027_Status.Enable = enable;
+    Iw7027_Status.Fault = 0;
+    Iw7027_MonDev = 0;
+    Iw7027_MonWait = 0;
+}
+
+tIw7027_Status *Iw7027_getStatus(void)
+{
+    return &Iw7027_Status;
+}
+
 IW7027_RET Iw7027_setCurrent(uint8_t current)
 {
-    IW7027_RET status;
+    //Current already set , no need to run the sequence.
+    if (Iw7027_checkReg(IW_SEL_ALL, 0x27, current))
+    {
+        return IW7027_SUCCESS;
+    }
+
+    //Sequence is queued and finished within several frames , the frame loop never waits for the status check.
+    if (IW7027_QUEUE_SIZE - 1 - Iw7027_getQueueCount() < 4)
+    {
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : Queue full.", __FUNCTION__);
+        return IW7027_FAIL;
+    }
 
     //Write data to IW7037
     //1 . Disable Protect , Set [FAUL_LOCK] (0x62  BIT0)to 1
-    Iw7027_putc( IW_SEL_ALL, 0x62, 0x01);
+    Iw7027_queueWrite(IW_SEL_ALL, 0x62, 0x01, 0);
 
     //2 . Write current to 0x27
-    Iw7027_putc( IW_SEL_ALL, 0x27, current);
+    Iw7027_queueWrite(IW_SEL_ALL, 0x27, current, 0);
 
     //3 . Check status. Low 4 bit of 0xB3 = 0x05
-    status = Iw7027_checkGetWithTimeOut( IW_SEL_ALL, 0xB3, 0x05, 0x0F);
+    Iw7027_queuePoll(IW_SEL_ALL, 0xB3, 0x05, 0x0F, Iw7027_setCurrentCallback);
 
     //4 . Enable Protect , Set [FAULT LOCK] (0x62  BIT0)to 0 ,IDAC_REMAP + FAUL_LOCK
-    Iw7027_putc( IW_SEL_ALL, 0x62, 0x00);
+    Iw7027_queueWrite(IW_SEL_ALL, 0x62, 0x00, 0);
 
-    return status;
+    return IW7027_SUCCESS;
 }
 
-IW7027_RET Iw7027_setFreq(uint8_t freq, uint8_t n);
+//Freq = 50 / 60 / 100 / 120Hz , n = PWM cycles per frame , only 1 supported. Finished by Iw7027_serviceQueue().
+IW7027_RET Iw7027_setFreq(uint8_t freq, uint8_t n)
+{
+    switch (freq)
+    {
+    case 50:
+    case 60:
+    case 100:
+    case 120:
+        break;
+    default:
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : freq = %d , not supported.", __FUNCTION__, freq);
+        return IW7027_FAIL;
+    }
+    if (n != 1)
+    {
+        //Multiplier needs a frequency register of IW7027 , not available.
+        IW7027_LOG("\r\nFUNC:[%s] ERROR : n = %d , not supported.", __FUNCTION__, n);
+        return IW7027_FAIL;
+    }
+
+    //Already working at this frequency.
+    if ((Iw7027_FreqReq == 0) && (freq == Iw7027_FreqStat.Freq))
+    {
+        return IW7027_SUCCESS;
+    }
+
+    //Stage VSYNC_OUT period in PWM timer , switched at the next boundary (VSYNC_OUT low) , no waiting here.
+    Iw7027_FreqReqTick = Clock_getTick();
+    Iw7027_FreqReq = freq;
+    if (PwmOut_setOutputSync(IW7027_PWM_OUT_CH, freq, IW7027_VSYNC_DUTY) == 0)
+    {
+        //VSYNC_OUT was off , switched at once.
+        Iw7027_serviceFreq();
+    }
+    return IW7027_SUCCESS;
+}
+
+tIw7027_FreqStat *Iw7027_getFreqStat(void)
+{
+    return &Iw7027_FreqStat;
+}
@@ -15,34 +15,129 @@
 #define IW_CH_ROW              10
 #define IW_CH_AMOUNT           IW_CH_COL*IW_CH_ROW
 
-#define IW7027_DEV_AMOUNT       4
+#define IW7027_DEV_MAX          16      //Maximum devices , 1 CS pin of SPI master each.
+#define IW7027_DEV_DEFAULT      4       //Device amount before Iw7027_setDevice() called.
 #define IW7027_CH_PER_DEV       16
-#define IW7027_DAISY_CHAIN      0
-
-#define IW_SEL_0                (0x0001)
-#define IW_SEL_1                (0x0002)
-#define IW_SEL_2                (0x0004)
-#define IW_SEL_3                (0x0008)
-//#define IW_SEL_4                (0x0010)
-//#define IW_SEL_5                (0x0020)
-//#define IW_SEL_6                (0x0040)
-//#define IW_SEL_7                (0x0080)
-#define IW_SEL_ALL              (IW_SEL_0 + IW_SEL_1 + IW_SEL_2  +IW_SEL_3 /*+ IW_SEL_4 + IW_SEL_5 + IW_SEL_6  +IW_SEL_7*/ )
-
-static const uint16_t IW_SEL_LIST[IW7027_DEV_AMOUNT] =
-{
-IW_SEL_0, IW_SEL_1, IW_SEL_2, IW_SEL_3
-//IW_SEL_4 ,IW_SEL_5, IW_SEL_6, IW_SEL_7,
-        };
+#define IW7027_DUTY_HEAD_SIZE       3                                   //Duty write of 1 device = 3 byte head + 32 byte data.
+#define IW7027_DUTY_SIZE_PER_DEV    (IW7027_CH_PER_DEV * 2)
+#define IW7027_DUTY_BYTE_PER_DEV    (IW7027_DUTY_HEAD_SIZE + IW7027_DUTY_SIZE_PER_DEV)
+#define IW7027_DAISY_CHAIN      0       //1 = All devices on 1 daisy-chain , addressed by chip ID in 1 CS window. Not verified.
+#define IW7027_DUTY_REFRESH     60      //Force re-send duty of all devices every N frames. 0 = always send.
+#define IW7027_INIT_TABLE_SIZE  0x60    //Initialize table of 1 device , register 0x00~0x5F.
+
+#define IW7027_QUEUE_SIZE           16  //Register transaction queue depth.
+#define IW7027_QUEUE_OPS_PER_FRAME  2   //SPI transactions serviced per frame.
+#define IW7027_QUEUE_POLL_RETRY     10  //Poll read times before fail.
+#define IW7027_QUEUE_POLL_INTERVAL  6   //Frames between poll retry , ~100ms at 60Hz.
+
+#define IW7027_SHADOW_SIZE          0x70    //Registers 0x00~0x6F are cached by shadow , except 0x00 & duty.
+#define IW7027_SHADOW_GAP_MERGE     3       //Clean registers between 2 dirty runs still merged , cheaper than a new head.
+
+/* Background monitor , registers are read 1 by 1 (no burst read documented) , only evaluated ones are scanned.
+ * [0xB3] low 4 bit = 0x05 in normal working state , same check as Iw7027_setCurrent().
+ */
+#define IW7027_MON_BASE             0xB3    //1st status register scanned by background monitor.
+#define IW7027_MON_SIZE             1       //Status registers scanned of each device.
+#define IW7027_MON_STATE_MASK       0x0F
+#define IW7027_MON_STATE_OK         0x05
+#define IW7027_MON_INTERVAL         15      //Frames between 2 scan slices , 1 slice = 1 device.
+
+/* Device select , each bit indicates 1 device (IW_0 ~ IW_15).
+ * Device to CS pin mapping is set by Iw7027_setDevice() , default IW_N on CS_N.
+ */
+#define IW_SEL(dev)             ((uint16_t) 1 << (dev))
+#define IW_SEL_0                IW_SEL(0)
+#define IW_SEL_ALL              (0xFFFF)
 
 typedef enum IW7027_RET
 {
     IW7027_FAIL = 0x00, IW7027_SUCCESS = 0x01
 } IW7027_RET;
 
+typedef enum IW7027_QUEUE_OP
+{
+    IW_Q_WRITE = 0x00,          //Write 1 register.
+    IW_Q_READ = 0x01,           //Read 1 register.
+    IW_Q_POLL = 0x02,           //Read 1 register of every selected device until (value & mask) == compare value.
+
+    IW_Q_BOTTOM = 0xFF
+} IW7027_QUEUE_OP;
+
+/*!@brief   Transaction finish callback.
+ * @param   iw_sel  is the selected devices of the transaction.
+ * @param   reg     is the register address.
+ * @param   val     is the written / read value.
+ * @param   status  is IW7027_SUCCESS , or IW7027_FAIL when poll timeout.
+ */
+typedef void (*tIw7027_QueueCallback)(uint16_t iw_sel, uint8_t reg, uint8_t val, IW7027_RET status);
+
+typedef struct tIw7027_QueueItem
+{
+    IW7027_QUEUE_OP Op;
+    uint16_t Sel;
+    uint8_t Reg;
+    uint8_t Val;                //Write value , or compare value of poll.
+    uint8_t Mask;               //Compare mask of poll.
+    tIw7027_QueueCallback Callback;
+} tIw7027_QueueItem;
+
+typedef struct tIw7027_DutyStat
+{
+    uint16_t FrameCount;        //Frames handled by Iw7027_setDuty().
+    uint8_t DevSent;            //Devices transmitted in last frame.
+    uint8_t DevSkipped;         //Devices skipped in last frame (duty not changed).
+    uint16_t ByteSaved;         //SPI bytes saved in last frame.
+    uint16_t UsSaved;           //SPI time saved in last frame , unit in us.
+    uint32_t ByteSavedTotal;    //SPI bytes saved since initialize.
+} tIw7027_DutyStat;
+
+typedef struct tIw7027_Status
+{
+    uint8_t Reg[IW7027_DEV_MAX][IW7027_MON_SIZE];       //Latest status registers of each device , from IW7027_MON_BASE.
+    uint16_t ScanCount[IW7027_DEV_MAX];                 //Times of each device scanned.
+    uint16_t Fault;                                     //Devices not in normal state at last scan , bit = device.
+    uint8_t Enable;                                     //Background monitor working.
+} tIw7027_Status;
+
+typedef struct tIw7027_FreqStat
+{
+    uint8_t Freq;               //[Hz] Working frame frequency , 0 = not set.
+    uint16_t SwitchCount;       //Frequency switches done.
+    uint16_t TimeoutCount;      //Switches with VSYNC_OUT period boundary not seen in time.
+    uint16_t WaitUs;            //Last switch : request to new VSYNC_OUT period seen by service.
+} tIw7027_FreqStat;
+
+typedef struct tIw7027_InitStat
+{
+    uint16_t IdFail;            //Devices failed chip ID check.
+    uint8_t IdRound;            //Chip ID read rounds until all matched.
+    uint8_t TableWrite;         //SPI bursts of initialize table , broadcast + differences.
+    uint32_t ResetUs;           //Reset to all chip IDs readable.
+    uint32_t TableUs;           //Initialize table written.
+    uint32_t LockUs;            //VSYNC_OUT on to IW7027 locked.
+    uint32_t TotalUs;           //Total initialize time.
+} tIw7027_InitStat;
+
+#define IW7027_LAYOUT_RUN_MAX   128     //Maximum runs of channel layout.
+
+//Continuous channels of 1 device taking continuous duty.
+typedef struct tIw7027_LayoutRun
+{
+    uint8_t Src;                //1st duty index.
+    uint8_t Dst;                //1st channel of device.
+    uint8_t Len;                //Channel amount.
+} tIw7027_LayoutRun;
+
+typedef struct tIw7027_Layout
+{
+    uint8_t ChAmount;                                           //Duty amount , 0 = not built.
+    uint8_t DevRun[IW7027_DEV_MAX + 1];                         //1st run of each device , last = run amount.
+    tIw7027_LayoutRun Run[IW7027_LAYOUT_RUN_MAX];
+} tIw7027_Layout;
+
 typedef struct tIw7027_InitParam
 {
-    uint16_t CH_EN[IW7027_DEV_AMOUNT];
+    uint16_t CH_EN[IW7027_DEV_MAX];
 } tIw7027_InitParam;
 
 IW7027_RET Iw7027_puts(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data);
@@ -57,10 +152,53 @@ IW7027_RET Iw7027_checkGetWithTimeOut(uint16_t iw_sel, uint8_t reg, uint8_t comp
 
 IW7027_RET Iw7027_init(uint8_t bon, uint8_t *init_map);
 
-IW7027_RET Iw7027_setDuty(uint16_t *duty, uint8_t *sort_map);
+tIw7027_InitStat *Iw7027_getInitStat(void);
+
+IW7027_RET Iw7027_setDevice(uint8_t dev_amount, const uint16_t *cs_map);
+
+uint8_t Iw7027_getDevAmount(void);
+
+IW7027_RET Iw7027_setCsTiming(uint16_t iw_sel, uint16_t setup_us, uint16_t hold_us);
+
+IW7027_RET Iw7027_setLayout(const uint8_t *sort_map, uint8_t ch_amount);
+
+IW7027_RET Iw7027_setDuty(uint16_t *duty);
+
+void Iw7027_forceDutyRefresh(void);
+
+tIw7027_DutyStat *Iw7027_getDutyStat(void);
+
+IW7027_RET Iw7027_queueWrite(uint16_t iw_sel, uint8_t reg, uint8_t u8data, tIw7027_QueueCallback callback);
+
+IW7027_RET Iw7027_queueRead(uint16_t iw_sel, uint8_t reg, tIw7027_QueueCallback callback);
+
+IW7027_RET Iw7027_queuePoll(uint16_t iw_sel, uint8_t reg, uint8_t compare_val, uint8_t compare_mask,
+        tIw7027_QueueCallback callback);
+
+uint8_t Iw7027_serviceQueue(uint8_t max_op);
+
+uint8_t Iw7027_getQueueCount(void);
+
+IW7027_RET Iw7027_stageReg(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data);
+
+uint8_t Iw7027_flushReg(uint16_t iw_sel);
+
+IW7027_RET Iw7027_writeReg(uint16_t iw_sel, uint8_t reg, uint8_t len, uint8_t *pu8data);
+
+uint8_t Iw7027_checkReg(uint16_t iw_sel, uint8_t reg, uint8_t u8data);
+
+void Iw7027_invalidateReg(uint16_t iw_sel);
+
+void Iw7027_resyncReg(uint16_t iw_sel);
+
+void Iw7027_setMonitor(uint8_t enable);
+
+tIw7027_Status *Iw7027_getStatus(void);
 
 IW7027_RET Iw7027_setCurrent(uint8_t current);
 
 IW7027_RET Iw7027_setFreq(uint8_t freq, uint8_t n);
 
+tIw7027_FreqStat *Iw7027_getFreqStat(void);
+
 #endif /* BSP_IW7027_IW7027_H_ */
@@ -31,6 +31,24 @@ void Mcu_reset(void)
     PMMCTL0_L |= PMMSWPOR;
 }
 
+//CRC16 CCITT , 4 bit table.
+static const unsigned int MCU_CRC_TABLE[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+unsigned int Mcu_crc16(const unsigned char *s, unsigned int len)
+{
+    unsigned int crc = 0xFFFF;
+    while (len--)
+    {
+        crc = (crc << 4) ^ MCU_CRC_TABLE[((crc >> 12) ^ (*s >> 4)) & 0x0F];
+        crc = (crc << 4) ^ MCU_CRC_TABLE[((crc >> 12) ^ (*s++ & 0x0F)) & 0x0F];
+    }
+    return crc;
+}
+
 void Mcu_init(unsigned char bon)
 {
     if (bon)
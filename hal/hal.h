@@ -17,6 +17,7 @@
 #include "hal_spi.h"
 #include "hal_pwm.h"
 #include "hal_i2c.h"
+#include "hal_dlog.h"
 
 /*!@brief   Initialize MCU .
  *
@@ -29,4 +30,12 @@ extern void Mcu_init(unsigned char bon);
  */
 extern void Mcu_reset(void);
 
+/*!@brief   CRC16 CCITT , poly 0x1021 , init 0xFFFF , no final XOR.
+ *
+ * @param   s    : is the pointer of data.
+ * @param   len  : is the length of data.
+ * @return  CRC16 of data.
+ */
+extern unsigned int Mcu_crc16(const unsigned char *s, unsigned int len);
+
 #endif /* HAL_HAL_H_ */
@@ -10,9 +10,34 @@
 
 #include "hal_clock.h"
 
+/*****************************************************************************
+ * Internal Variables.
+ *****************************************************************************/
+volatile unsigned int Clock_TickHigh;           //High word of tick , TB0 overflow count.
+
 /*****************************************************************************
  * Internal Functions.
  *****************************************************************************/
+// TB0 overflow ISR
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector=TIMER0_B1_VECTOR
+__interrupt void Clock_Tick_Isr(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_B1_VECTOR))) Clock_Tick_Isr (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    switch (__even_in_range(TB0IV, 14))
+    {
+    case 14:          //Over Flow
+        Clock_TickHigh++;
+        break;
+    default:
+        break;
+    }
+}
+
 /*!@brief Set MSP430 VCORE level up.
  * @param level  [1~3] 3 Core level .
  */
@@ -109,6 +134,33 @@ void Clock_init(void)
         // Clear XT2,XT1,DCO fault flags
         SFRIFG1 &= ~OFIFG;    // Clear fault flags
     } while (SFRIFG1 & OFIFG);                  // Test oscillator fault flag
+
+    /*[4] Start tick timebase.
+     *  TB0 SMCLK source , DIV = MCLK / SMCLK / 16 , continuous mode , overflow counts high word.
+     */
+    Clock_TickHigh = 0;
+    TB0EX0 = (1 << (CLOCK_TICK_DIV_BIT - CLOCK_TICK_ID_BIT)) - 1;
+    TB0CTL = TBSSEL__SMCLK + ID_1 * CLOCK_TICK_ID_BIT + MC__CONTINUOUS + TBCLR + TBIE;
+}
+
+unsigned long Clock_getTick(void)
+{
+    unsigned int high, low;
+
+    //Read again if overflow ISR runs between the 2 words.
+    do
+    {
+        high = Clock_TickHigh;
+        low = TB0R;
+    } while (high != Clock_TickHigh);
+
+    //Overflow not serviced yet (interrupt disabled).
+    if ((TB0CTL & TBIFG) && (low < 0x8000))
+    {
+        high++;
+    }
+
+    return ((unsigned long) high << 16) | low;
 }
 
 
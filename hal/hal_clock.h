@@ -46,10 +46,27 @@
 #define WATCHDOG_HOLD       WDTCTL = WDTPW | WDTHOLD                /*Watch dog disable */
 #define WATCHDOG_FEED       WDTCTL = WDT_ARST_1000                  /*Watch dog feed , ALCK source , 1000ms.*/
 
+/****************************************************************************
+ * Tick timebase , TB0 continuous mode , MCLK / 16 whatever SMCLK divider is.
+ * TB0 divider = ID (/1~/8) x TBIDEX (/1~/8).
+ *****************************************************************************/
+#define CLOCK_TICK_DIV_BIT      (4 - SMCLK_DIV_BIT)                                     /*SMCLK / tick.*/
+#define CLOCK_TICK_ID_BIT       (CLOCK_TICK_DIV_BIT > 3 ? 3 : CLOCK_TICK_DIV_BIT)       /*TB0 ID.*/
+#define CLOCK_TICK_F            (SMCLK_F >> CLOCK_TICK_DIV_BIT)                         /*Tick frequency.*/
+#define CLOCK_TICK_TO_US(t)     ((unsigned long) ((unsigned long long) (t) * 1000000UL / CLOCK_TICK_F))
+#define CLOCK_US_TO_TICK(us)    ((unsigned long) ((unsigned long long) (us) * CLOCK_TICK_F / 1000000UL))
+#define CLOCK_MS_TO_TICK(ms)    ((unsigned long) ((unsigned long long) (ms) * CLOCK_TICK_F / 1000UL))
+
 /*!@fn      Clock_init
  * @brief   Initialize MSP430 clock system .
  *          The parameters are pre-defined , do not support dynamic change now.
  */
 extern void Clock_init(void);
 
+/*!@fn      Clock_getTick
+ * @brief   Get ticks since Clock_init() , unit in 1 / CLOCK_TICK_F second , rolls over.
+ *          Compare ticks by subtraction : (Clock_getTick() - start) >= CLOCK_MS_TO_TICK(ms).
+ */
+extern unsigned long Clock_getTick(void);
+
 #endif /* HAL_HAL_CLOCK_H_ */
@@ -0,0 +1,121 @@
+/**@file    hal_dlog.c
+ *
+ * Deferred log , printf style call sites without formatting on MCU.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version , deferred log with format ID.
+ */
+
+#include "hal_dlog.h"
+#include "hal_clock.h"
+#include "stdarg.h"
+
+/*****************************************************************************
+ * Internal Variables
+ *****************************************************************************/
+#define DLOG_MASK           (DLOG_BUF_SIZE - 1)
+#define DLOG_BUSY           0xFF                //Arg amount of a reserved record still being filled.
+
+/* Records may be written from ISR , only the space is reserved with interrupt disabled.
+ * Record is filled with interrupt enabled , arg amount is written last and releases it to reader.
+ */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_SECTION(Dlog_Ring, ".usbram")          //USB not used , save RAM.
+#endif
+static unsigned char Dlog_Ring[DLOG_BUF_SIZE];
+static volatile unsigned int Dlog_Head = 0;         //Free running.
+static volatile unsigned int Dlog_Tail = 0;         //Free running , written by reader.
+static tDlog_Stat Dlog_Stat;
+
+/*****************************************************************************
+ * Internal Functions
+ *****************************************************************************/
+static void Dlog_put(unsigned int pos, const void *s, unsigned char len)
+{
+    const unsigned char *p = s;
+    while (len--)
+    {
+        Dlog_Ring[pos++ & DLOG_MASK] = *p++;
+    }
+}
+
+/*****************************************************************************
+ * External Functions
+ *****************************************************************************/
+void Dlog_write(const char *fmt, unsigned char narg, ...)
+{
+    va_list ap;
+    unsigned int pos, start, id;
+    unsigned char i;
+    unsigned long tick;
+    long arg;
+
+    if (narg > DLOG_ARG_MAX)
+    {
+        narg = DLOG_ARG_MAX;
+    }
+    unsigned char size = DLOG_HEAD_SIZE + narg * 4;
+    tick = Clock_getTick();
+
+    //Reserve record space , marked busy until filled.
+    unsigned short gie = __get_interrupt_state();
+    __disable_interrupt();
+    pos = Dlog_Head;
+    if ((unsigned int) (DLOG_BUF_SIZE - (pos - Dlog_Tail)) < size)
+    {
+        Dlog_Stat.Drop++;
+        __set_interrupt_state(gie);
+        return;
+    }
+    Dlog_Ring[pos & DLOG_MASK] = DLOG_BUSY;
+    Dlog_Head = pos + size;
+    Dlog_Stat.Count++;
+    if ((unsigned int) (Dlog_Head - Dlog_Tail) > Dlog_Stat.MaxUsed)
+    {
+        Dlog_Stat.MaxUsed = Dlog_Head - Dlog_Tail;
+    }
+    __set_interrupt_state(gie);
+
+    //Fill record , native byte order.
+    start = pos;
+    id = (unsigned int) fmt;
+    Dlog_put(pos + 1, &id, 2);
+    Dlog_put(pos + 3, &tick, 4);
+    pos += DLOG_HEAD_SIZE;
+
+    va_start(ap, narg);
+    for (i = 0; i < narg; i++)
+    {
+        arg = va_arg(ap, long);
+        Dlog_put(pos, &arg, 4);
+        pos += 4;
+    }
+    va_end(ap);
+    Dlog_Ring[start & DLOG_MASK] = narg;
+}
+
+unsigned int Dlog_read(unsigned char *s)
+{
+    unsigned int tail = Dlog_Tail;
+    unsigned int i, size;
+
+    //Oldest record still being filled , records behind it wait.
+    if ((tail == Dlog_Head) || (Dlog_Ring[tail & DLOG_MASK] == DLOG_BUSY))
+    {
+        return 0;
+    }
+    size = DLOG_HEAD_SIZE + Dlog_Ring[tail & DLOG_MASK] * 4;
+    for (i = 0; i < size; i++)
+    {
+        s[i] = Dlog_Ring[tail++ & DLOG_MASK];
+    }
+    Dlog_Tail = tail;
+    return size;
+}
+
+tDlog_Stat *Dlog_getStat(void)
+{
+    return &Dlog_Stat;
+}
@@ -0,0 +1,94 @@
+/**@file    hal_dlog.h
+ *
+ * Deferred log , printf style call sites without formatting on MCU.
+ *
+ * DLOG("fmt" , args...) stores 1 binary record into a RAM ring :
+ *   [Arg amount:1] [Format ID:2] [Tick:4] [Arg:4 x Arg amount]
+ * Format ID is the address of the format string in section ".dlog" , the section is kept in the
+ * output file but not loaded to flash (see lnk_msp430f5529.cmd). Args are stored as long ,
+ * %s args must point to constant strings (e.g. __FUNCTION__) , they are read from the output file by host.
+ * Records are sent out by app_telem & formatted by host : tools/telem_decode.py --elf <out file>.
+ *
+ * DLOG is for log lines of hot paths (player / BSP / PLIMIT). Console replies & bulk dumps stay on printf ,
+ * the ring holds only some records between 2 main loop drains.
+ *
+ * DLOG_ENABLE = 0 : DLOG is printf , nothing else changes.
+ *
+ * @history
+ * Date     | Author  | Comment
+ * ------------------------------------
+ * 20261019 | agent   | Initial Version.
+ */
+
+#ifndef HAL_HAL_DLOG_H_
+#define HAL_HAL_DLOG_H_
+
+#include <stdio.h>
+
+#define DLOG_ENABLE             1       //1 : Deferred log  0 : printf.
+#define DLOG_BUF_SIZE           256     //Record ring size , power of 2.
+#define DLOG_ARG_MAX            8       //Maximum args of 1 log.
+#define DLOG_HEAD_SIZE          7       //Record bytes before args.
+#define DLOG_RECORD_MAX         (DLOG_HEAD_SIZE + DLOG_ARG_MAX * 4)
+
+#if DLOG_ENABLE
+
+//Arg counting & casting , up to DLOG_ARG_MAX args.
+#define DLOG_CAT(a, b)          DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b)         a##b
+#define DLOG_NARG(...)          DLOG_NARG_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARG_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...)  n
+#define DLOG_L(x)               ((long) (x))
+#define DLOG_A0()
+#define DLOG_A1(a)                          , DLOG_L(a)
+#define DLOG_A2(a, b)                       DLOG_A1(a), DLOG_L(b)
+#define DLOG_A3(a, b, c)                    DLOG_A2(a, b), DLOG_L(c)
+#define DLOG_A4(a, b, c, d)                 DLOG_A3(a, b, c), DLOG_L(d)
+#define DLOG_A5(a, b, c, d, e)              DLOG_A4(a, b, c, d), DLOG_L(e)
+#define DLOG_A6(a, b, c, d, e, f)           DLOG_A5(a, b, c, d, e), DLOG_L(f)
+#define DLOG_A7(a, b, c, d, e, f, g)        DLOG_A6(a, b, c, d, e, f), DLOG_L(g)
+#define DLOG_A8(a, b, c, d, e, f, g, h)     DLOG_A7(a, b, c, d, e, f, g), DLOG_L(h)
+
+/******************************************************************************
+ * @fn      DLOG
+ * @brief   Deferred log , usage is the same as printf() , format must be a string literal.
+ *****************************************************************************/
+#define DLOG(fmt, ...)  do { \
+    static const char DLOG_FMT[] __attribute__((section(".dlog"))) = fmt; \
+    Dlog_write(DLOG_FMT, DLOG_NARG(__VA_ARGS__) DLOG_CAT(DLOG_A, DLOG_NARG(__VA_ARGS__))(__VA_ARGS__)); \
+} while (0)
+
+#else
+#define DLOG                    printf
+#endif
+
+typedef struct tDlog_Stat
+{
+    unsigned int Count;         //Records written.
+    unsigned int Drop;          //Records dropped , ring full.
+    unsigned int MaxUsed;       //Peak bytes in ring.
+} tDlog_Stat;
+
+/******************************************************************************
+ * @fn      Dlog_write
+ * @brief   Store 1 record , called by DLOG macro. Record is dropped when ring is full.
+ * @param   fmt     is the format string in section ".dlog".
+ * @param   narg    is the number of args , each passed as long.
+ *****************************************************************************/
+extern void Dlog_write(const char *fmt, unsigned char narg, ...);
+
+/******************************************************************************
+ * @fn      Dlog_read
+ * @brief   Take the oldest record out of ring.
+ * @param   s   is the pointer to destination , DLOG_RECORD_MAX bytes.
+ * @return  Record size , 0 = no record.
+ *****************************************************************************/
+extern unsigned int Dlog_read(unsigned char *s);
+
+/******************************************************************************
+ * @fn      Dlog_getStat
+ * @return  Pointer to deferred log statistics.
+ *****************************************************************************/
+extern tDlog_Stat *Dlog_getStat(void);
+
+#endif /* HAL_HAL_DLOG_H_ */
@@ -10,6 +10,7 @@
 
 #include "hal_i2c.h"
 #include "board.h"
+#include "hal_clock.h"
 
 /***[ I2C Slave ] start*******************************************************/
 
@@ -32,31 +33,181 @@
 #define I2C_S_RXBUF         UCB0RXBUF
 #define I2C_S_TXBUF         UCB0TXBUF
 #define I2C_S_STAT          UCB0STAT
+#define I2C_S_DMA_RX_TRIG   DMA1TSEL_18         //UCB0 RX
+#define I2C_S_DMA_TX_TRIG   DMA2TSEL_19         //UCB0 TX
 #endif
 
 #if I2C_SLAVE_BASE == USCI_B1_BASE
 
 #endif
-#define I2C_S_RXBUF_SIZE    128
-#define I2C_S_TXBUF_SIZE    128
+#define I2C_S_RXBUF_SIZE    I2C_S_MBOX_SIZE
+#define I2C_S_TXBUF_SIZE    I2C_S_MBOX_SIZE
+#define I2C_S_ADDR_SIZE     2
+
+//DMA1 = slave RX , DMA2 = slave TX , DMA0 is used by SPI slave.
+#define I2C_S_RX_DMACTL0    DMACTL0
+#define I2C_S_RX_DMACTL     DMA1CTL
+#define I2C_S_RX_DMASZ      DMA1SZ
+#define I2C_S_RX_DMASA      DMA1SA
+#define I2C_S_RX_DMADA      DMA1DA
+#define I2C_S_TX_DMACTL1    DMACTL1
+#define I2C_S_TX_DMACTL     DMA2CTL
+#define I2C_S_TX_DMASZ      DMA2SZ
+#define I2C_S_TX_DMASA      DMA2SA
+#define I2C_S_TX_DMADA      DMA2DA
 
 /*****************************************************************************
  * [ I2C Slave ]  operation buffers.
  *****************************************************************************/
 
-static unsigned int I2cSlave_RxCount;
-static unsigned int I2cSlave_TxCount;
-
-unsigned char *I2cSlave_RxPtr = 0;
-unsigned char *I2cSlave_TxPtr = 0;
+static unsigned int I2cSlave_RxCount;               //Mailbox bytes of current write.
+static volatile unsigned int I2cSlave_RxDone = 0;   //Mailbox bytes of last complete write , cleared by I2cSlave_gets.
 
 static unsigned char I2cSlave_RxBuf[I2C_S_RXBUF_SIZE];
-static unsigned char I2cSlave_TxBuf[I2C_S_TXBUF_SIZE] =
-{ 1, 2, 3, 4, 5, 6, 7, 8 };
+static unsigned char I2cSlave_TxBuf[I2C_S_TXBUF_SIZE];
+
+static const tI2cSlave_Window *I2cSlave_Win = 0;
+static unsigned char I2cSlave_WinAmount = 0;
+
+//Register access state of current transfer.
+static unsigned int I2cSlave_Addr;                  //Register address of next byte.
+static unsigned char I2cSlave_AddrCount;            //Address bytes received.
+static unsigned char *I2cSlave_Ptr;                 //Memory of I2cSlave_Addr.
+static unsigned int I2cSlave_Left;                  //Bytes left in window from I2cSlave_Ptr , 0 = seek again.
+static unsigned char I2cSlave_Access;
+
+static unsigned int I2cSlave_DmaRx = 0;             //Bytes given to RX DMA , 0 = not running.
+static unsigned int I2cSlave_DmaTx = 0;             //Bytes given to TX DMA , 0 = not running.
+static tI2cSlave_Stat I2cSlave_Stat;
+
 /*****************************************************************************
  * [ I2C Slave ]  Internal functions.
  *****************************************************************************/
 
+/*! Locate window of I2cSlave_Addr , mailbox first. */
+static void I2cSlave_seek(unsigned char tx)
+{
+    unsigned int offset = I2cSlave_Addr - I2C_S_MBOX_ADDR;
+    unsigned char i;
+
+    if (offset < I2C_S_MBOX_SIZE)
+    {
+        I2cSlave_Ptr = (tx ? I2cSlave_TxBuf : I2cSlave_RxBuf) + offset;
+        I2cSlave_Left = I2C_S_MBOX_SIZE - offset;
+        I2cSlave_Access = tx ? I2C_S_WIN_READ : I2C_S_WIN_WRITE;
+        return;
+    }
+    for (i = 0; i < I2cSlave_WinAmount; i++)
+    {
+        offset = I2cSlave_Addr - I2cSlave_Win[i].Addr;
+        if (offset < I2cSlave_Win[i].Size)
+        {
+            I2cSlave_Ptr = (unsigned char *) I2cSlave_Win[i].Data + offset;
+            I2cSlave_Left = I2cSlave_Win[i].Size - offset;
+            I2cSlave_Access = I2cSlave_Win[i].Access;
+            return;
+        }
+    }
+    I2cSlave_Left = 0;
+}
+
+/*! Bytes moved in window , by ISR or DMA. */
+static void I2cSlave_move(unsigned int n, unsigned char rx)
+{
+    I2cSlave_Ptr += n;
+    I2cSlave_Left -= n;
+    I2cSlave_Addr += n;
+    if (!rx)
+    {
+        I2cSlave_Stat.TxByte += n;
+        return;
+    }
+    I2cSlave_Stat.RxByte += n;
+    if (n && ((unsigned int) (I2cSlave_Addr - 1 - I2C_S_MBOX_ADDR) < I2C_S_MBOX_SIZE))
+    {
+        I2cSlave_RxCount = I2cSlave_Addr - I2C_S_MBOX_ADDR;
+    }
+}
+
+/*! Hand rest of writable window to DMA , USCI RX interrupt is off until DMA ends.
+ *  Level trigger as SPI slave , a byte already waiting in RXBUF is taken at once.
+ */
+static void I2cSlave_dmaRx(void)
+{
+#if I2C_S_DMA_ENABLE
+    if ((I2cSlave_Left >= I2C_S_DMA_MIN) && (I2cSlave_Access & I2C_S_WIN_WRITE))
+    {
+        I2C_S_IE &= ~UCRXIE;
+        I2cSlave_DmaRx = I2cSlave_Left;
+        I2C_S_RX_DMASZ = I2cSlave_Left;
+        __data16_write_addr((unsigned short) &I2C_S_RX_DMADA, (unsigned long) I2cSlave_Ptr);
+        I2C_S_RX_DMACTL = DMADT_0 + DMASRCINCR_0 + DMADSTINCR_3 + DMASBDB + DMALEVEL + DMAIE + DMAEN;
+    }
+#endif
+}
+
+/*! Hand rest of readable window to DMA , USCI TX interrupt is off until DMA ends. */
+static void I2cSlave_dmaTx(void)
+{
+#if I2C_S_DMA_ENABLE
+    if ((I2cSlave_Left >= I2C_S_DMA_MIN) && (I2cSlave_Access & I2C_S_WIN_READ))
+    {
+        I2C_S_IE &= ~UCTXIE;
+        I2cSlave_DmaTx = I2cSlave_Left;
+        I2C_S_TX_DMASZ = I2cSlave_Left;
+        __data16_write_addr((unsigned short) &I2C_S_TX_DMASA, (unsigned long) I2cSlave_Ptr);
+        I2C_S_TX_DMACTL = DMADT_0 + DMASRCINCR_3 + DMADSTINCR_0 + DMASBDB + DMALEVEL + DMAIE + DMAEN;
+    }
+#endif
+}
+
+/*! End RX DMA , at DMA done (all bytes) or at STOP / START (bytes so far). */
+static void I2cSlave_dmaRxEnd(unsigned char done)
+{
+    unsigned int n;
+
+    if (!I2cSlave_DmaRx)
+    {
+        return;
+    }
+    I2C_S_RX_DMACTL &= ~DMAEN;
+    //DMAIFG pending : done but DMA ISR not run yet , DMASZ is reloaded already.
+    n = (done || (I2C_S_RX_DMACTL & DMAIFG)) ? I2cSlave_DmaRx : I2cSlave_DmaRx - I2C_S_RX_DMASZ;
+    I2C_S_RX_DMACTL &= ~DMAIFG;
+    I2cSlave_DmaRx = 0;
+    I2cSlave_Stat.DmaByte += n;
+    I2cSlave_move(n, 1);
+    I2C_S_IE |= UCRXIE;
+}
+
+/*! End TX DMA , at DMA done (all bytes) or at STOP / START (bytes so far). */
+static void I2cSlave_dmaTxEnd(unsigned char done)
+{
+    unsigned int n;
+
+    if (!I2cSlave_DmaTx)
+    {
+        return;
+    }
+    I2C_S_TX_DMACTL &= ~DMAEN;
+    n = (done || (I2C_S_TX_DMACTL & DMAIFG)) ? I2cSlave_DmaTx : I2cSlave_DmaTx - I2C_S_TX_DMASZ;
+    I2C_S_TX_DMACTL &= ~DMAIFG;
+    I2cSlave_DmaTx = 0;
+    I2cSlave_Stat.DmaByte += n;
+    I2cSlave_move(n, 0);
+    I2C_S_IE |= UCTXIE;
+}
+
+/*! Mailbox write complete at STOP or repeated START. */
+static void I2cSlave_rxDone(void)
+{
+    if (I2cSlave_RxCount)
+    {
+        I2cSlave_RxDone = I2cSlave_RxCount;
+        I2cSlave_RxCount = 0;
+    }
+}
+
 #if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
 #pragma vector = I2C_S_VECTOR
 __interrupt void USCI_B0_ISR(void)
@@ -76,23 +227,106 @@ void __attribute__ ((interrupt(I2C_S_VECTOR))) USCI_B0_ISR (void)
         break;
     case 6:     // Vector  6: STTIFG
         I2C_S_IFG &= ~UCSTTIFG;
-        I2cSlave_RxCount = 0;
-        I2cSlave_TxCount = 0;
+        I2cSlave_dmaRxEnd(0);
+        I2cSlave_dmaTxEnd(0);
+        I2cSlave_rxDone();
+        I2cSlave_Stat.Transfer++;
+        I2cSlave_Left = 0;
+        if (!(I2C_S_CTL1 & UCTR))
+        {
+            //Write , register address follows.
+            I2cSlave_Addr = 0;
+            I2cSlave_AddrCount = 0;
+        }
+        else
+        {
+            //Read , TXIFG is set with STTIFG , DMA takes it when started here.
+            I2cSlave_seek(1);
+            I2cSlave_dmaTx();
+        }
         break;
     case 8:     // Vector  8: STPIFG
+        I2cSlave_dmaRxEnd(0);
+        I2cSlave_dmaTxEnd(0);
+        I2cSlave_rxDone();
         break;
     case 10:     // Vector 10: RXIFG
-        I2cSlave_RxBuf[I2cSlave_RxCount] = I2C_S_RXBUF;
-        I2cSlave_RxCount++;
+    {
+        unsigned char byte = I2C_S_RXBUF;
+        if (I2cSlave_AddrCount < I2C_S_ADDR_SIZE)
+        {
+            I2cSlave_Addr = (I2cSlave_Addr << 8) | byte;
+            if (++I2cSlave_AddrCount == I2C_S_ADDR_SIZE)
+            {
+                I2cSlave_seek(0);
+                I2cSlave_dmaRx();
+            }
+            break;
+        }
+        if (!I2cSlave_Left)
+        {
+            I2cSlave_seek(0);
+        }
+        if (I2cSlave_Left && (I2cSlave_Access & I2C_S_WIN_WRITE))
+        {
+            *I2cSlave_Ptr = byte;
+            I2cSlave_move(1, 1);
+            I2cSlave_dmaRx();
+        }
+        else
+        {
+            I2cSlave_Addr++;
+            I2cSlave_Stat.RxByte++;
+        }
         break;
+    }
     case 12:     // Vector 12: TXIFG
-        I2C_S_TXBUF = I2cSlave_TxBuf[I2cSlave_TxCount];
-        I2cSlave_TxCount++;
+        if (!I2cSlave_Left)
+        {
+            I2cSlave_seek(1);
+        }
+        if (I2cSlave_Left && (I2cSlave_Access & I2C_S_WIN_READ))
+        {
+            I2C_S_TXBUF = *I2cSlave_Ptr;
+            I2cSlave_move(1, 0);
+            I2cSlave_dmaTx();
+        }
+        else
+        {
+            I2C_S_TXBUF = 0xFF;
+            I2cSlave_Addr++;
+            I2cSlave_Stat.TxByte++;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+#if I2C_S_DMA_ENABLE
+//DMA vector is shared , DMA0 of SPI slave runs without interrupt.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = DMA_VECTOR
+__interrupt void I2cSlave_DmaIsr(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(DMA_VECTOR))) I2cSlave_DmaIsr (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    switch (__even_in_range(DMAIV, 16))
+    {
+    case 4:     // Vector  4: DMA1IFG , RX window full , rest by ISR.
+        I2cSlave_dmaRxEnd(1);
+        break;
+    case 6:     // Vector  6: DMA2IFG , TX window end , rest by ISR.
+        I2cSlave_dmaTxEnd(1);
         break;
     default:
         break;
     }
 }
+#endif
 
 /*****************************************************************************
  * [ I2C Slave ]  External functions.
@@ -104,6 +338,14 @@ void I2cSlave_init(unsigned char slave_add)
     I2C_S_CTL0 = UCMODE_3 + UCSYNC;         // I2C Slave, synchronous mode
     I2C_S_OA = slave_add;                   // Slave Address
     I2C_S_CTL1 &= ~UCSWRST;                 // Enable USCI
+
+#if I2C_S_DMA_ENABLE
+    //DMA trigger & fixed USCI side address , memory side is set per window.
+    I2C_S_RX_DMACTL0 = (I2C_S_RX_DMACTL0 & 0x00FF) | I2C_S_DMA_RX_TRIG;
+    I2C_S_TX_DMACTL1 = (I2C_S_TX_DMACTL1 & 0xFF00) | I2C_S_DMA_TX_TRIG;
+    __data16_write_addr((unsigned short) &I2C_S_RX_DMASA, (unsigned long) &I2C_S_RXBUF);
+    __data16_write_addr((unsigned short) &I2C_S_TX_DMADA, (unsigned long) &I2C_S_TXBUF);
+#endif
     I2C_S_IE |= UCSTPIE + UCSTTIE + UCRXIE + UCTXIE;     // Enable interrupt.
 }
 
@@ -112,35 +354,59 @@ unsigned char I2cSlave_getc(void)
     return I2C_S_RXBUF;
 }
 
+void I2cSlave_setWindow(const tI2cSlave_Window *win, unsigned char amount)
+{
+    unsigned short gie = __get_interrupt_state();
+    __disable_interrupt();
+    I2cSlave_dmaRxEnd(0);
+    I2cSlave_dmaTxEnd(0);
+    I2cSlave_Win = win;
+    I2cSlave_WinAmount = amount;
+    I2cSlave_Left = 0;
+    __set_interrupt_state(gie);
+}
+
 unsigned int I2cSlave_gets(unsigned char *s)
 {
-    if (I2C_S_STAT & UCBBUSY)   //I2C is busy.
+    unsigned int i, len = I2cSlave_RxDone;
+
+    if ((len == 0) || (I2C_S_STAT & UCBBUSY))   //No data or I2C is busy.
     {
         return 0;
     }
 
-    unsigned int i;
-    for (i = 0; i < I2cSlave_RxCount; i++)
+    for (i = 0; i < len; i++)
     {
         *s++ = I2cSlave_RxBuf[i];
     }
-    return I2cSlave_RxCount;
+    I2cSlave_RxDone = 0;
+    return len;
 }
 
 void I2cSlave_putc(unsigned char c)
 {
-    I2C_S_TXBUF = c;
+    I2cSlave_puts(&c, 1);
 }
 
 void I2cSlave_puts(unsigned char *s, unsigned int len)
 {
     unsigned int i;
-    for (i = 0; i < I2cSlave_RxCount; i++)
+
+    if (len > I2C_S_TXBUF_SIZE)
+    {
+        len = I2C_S_TXBUF_SIZE;
+    }
+    for (i = 0; i < len; i++)
     {
         I2cSlave_TxBuf[i] = *s++;
     }
 }
 
+tI2cSlave_Stat *I2cSlave_getStat(void)
+{
+    return &I2cSlave_Stat;
+}
+
 /***[ I2C Slave ] start*******************************************************/
 
 #ifndef I2C_MASTER_BASE
@@ -152,6 +418,12 @@ void I2cSlave_puts(unsigned char *s, unsigned int len)
  *****************************************************************************/
 #if I2C_MASTER_BASE == USCI_B0_BASE
 #define SET_I2C_M_FUNC_IO   P3SEL |= BIT0+BIT1 //P3.0 = SDA , P3.1 = SCL
+#define I2C_M_PSEL          P3SEL
+#define I2C_M_PDIR          P3DIR
+#define I2C_M_POUT          P3OUT
+#define I2C_M_PIN           P3IN
+#define I2C_M_SDA           BIT0
+#define I2C_M_SCL           BIT1
 #define I2C_M_CTL1          UCB0CTL1
 #define I2C_M_CTL0          UCB0CTL0
 #define I2C_M_SA            UCB0I2CSA
@@ -168,6 +440,12 @@ void I2cSlave_puts(unsigned char *s, unsigned int len)
 
 #if I2C_MASTER_BASE == USCI_B1_BASE
 #define SET_I2C_M_FUNC_IO   P4SEL |= BIT1+BIT2  //P4.1 = SDA , P4.2 = SCL
+#define I2C_M_PSEL          P4SEL
+#define I2C_M_PDIR          P4DIR
+#define I2C_M_POUT          P4OUT
+#define I2C_M_PIN           P4IN
+#define I2C_M_SDA           BIT1
+#define I2C_M_SCL           BIT2
 #define I2C_M_CTL1          UCB1CTL1
 #define I2C_M_CTL0          UCB1CTL0
 #define I2C_M_SA            UCB1I2CSA
@@ -189,199 +467,331 @@ void I2cSlave_puts(unsigned char *s, unsigned int len)
 #define MCLK_F         1000000
 #endif
 
-#define I2C_M_TIMEOUT       MCLK_F / 4      //1 sec timeout.
+#define I2C_M_QUEUE_MASK    (I2C_M_QUEUE_SIZE - 1)
+#define I2C_M_STT_WAIT      (MCLK_F / 1000)         //Loops of waiting START / STOP sent , about 4ms.
+#define I2C_M_RECOVER_DELAY (MCLK_F / 200000)       //Half SCL cycle of bus recovery , 5us.
+#define I2C_M_BR_MIN        4                       //Minimum USCI master bit clock divider.
+
+typedef struct tI2cMaster_Xfer
+{
+    unsigned char SlvAdd;
+    const unsigned char *Tx;
+    unsigned int TxLen;
+    unsigned char *Rx;
+    unsigned int RxLen;
+    unsigned long Deadline;     //Clock_getTick().
+    I2cMaster_Done Done;
+    void *Arg;
+    I2C_MASTER_RET Ret;
+} tI2cMaster_Xfer;
 
 unsigned int I2cMaster_TxCount;
 unsigned int I2cMaster_RxCount;
 
-unsigned char *I2cMaster_TxPtr;
+const unsigned char *I2cMaster_TxPtr;
 unsigned char *I2cMaster_RxPtr;
 
-unsigned char I2cMaster_NackFlag;
+static unsigned long I2cMaster_Clk;
+static unsigned int I2cMaster_Br;
 
-void I2cMaster_init(unsigned long clk)
+/* Transaction ring , free running indexes.
+ * Tail <= Active <= Head : [Tail , Active) finished & waiting callback , [Active , Head) queued , Active on bus.
+ */
+static tI2cMaster_Xfer I2cMaster_Queue[I2C_M_QUEUE_SIZE];
+static volatile unsigned char I2cMaster_Head = 0;      //Written by submit.
+static volatile unsigned char I2cMaster_Active = 0;    //Written by ISR / service with interrupt disabled.
+static volatile unsigned char I2cMaster_Tail = 0;      //Written by service.
+static tI2cMaster_Stat I2cMaster_Stat;
+
+/*! Configure USCI as master , also after bus recovery. */
+static void I2cMaster_setup(void)
 {
-    SET_I2C_M_FUNC_IO;                   // Assign I2C pins to USCI_B0
+    SET_I2C_M_FUNC_IO;                          // Assign I2C pins to USCI
     I2C_M_CTL1 |= UCSWRST;                      // Enable SW reset
     I2C_M_CTL0 = UCMST + UCMODE_3 + UCSYNC;     // I2C Master, synchronous mode
     I2C_M_CTL1 = UCSSEL_2 + UCSWRST;            // Use SMCLK
-    I2C_M_BR0 = SMCLK_F / clk;                             // fSCL = SMCLK/12 = ~100kHz
-    I2C_M_BR1 = 0;
+    I2C_M_BR0 = I2cMaster_Br & 0xFF;            // fSCL = SMCLK / BR
+    I2C_M_BR1 = I2cMaster_Br >> 8;
 
     I2C_M_CTL1 &= ~UCSWRST;                     // Clear SW reset, resume operation
-    I2C_M_IE |= UCRXIE + UCTXIE + UCNACKIE;                         // Enable RX interrupt
+    I2C_M_IE |= UCRXIE + UCTXIE + UCNACKIE + UCALIE;
 }
 
-I2C_MASTER_RET I2cMaster_write(unsigned char slvadd, unsigned char *s, unsigned int len)
+/*! Free a stuck bus : up to 9 SCL pulses till slave releases SDA , then STOP. Pins as open drain GPIO. */
+static void I2cMaster_recover(void)
 {
-    //Check parameter.
-    if ((s == 0) || (len == 0))
+    unsigned char i;
+
+    I2C_M_CTL1 |= UCSWRST;
+    I2C_M_POUT &= ~(I2C_M_SDA + I2C_M_SCL);
+    I2C_M_PDIR &= ~(I2C_M_SDA + I2C_M_SCL);
+    I2C_M_PSEL &= ~(I2C_M_SDA + I2C_M_SCL);
+    for (i = 0; (i < 9) && !(I2C_M_PIN & I2C_M_SDA); i++)
     {
-        return I2C_MASTER_FAIL;
+        I2C_M_PDIR |= I2C_M_SCL;
+        __delay_cycles(I2C_M_RECOVER_DELAY);
+        I2C_M_PDIR &= ~I2C_M_SCL;
+        __delay_cycles(I2C_M_RECOVER_DELAY);
     }
+    I2C_M_PDIR |= I2C_M_SCL;
+    I2C_M_PDIR |= I2C_M_SDA;
+    __delay_cycles(I2C_M_RECOVER_DELAY);
+    I2C_M_PDIR &= ~I2C_M_SCL;
+    __delay_cycles(I2C_M_RECOVER_DELAY);
+    I2C_M_PDIR &= ~I2C_M_SDA;
+    __delay_cycles(I2C_M_RECOVER_DELAY);
+
+    I2cMaster_Stat.Recover++;
+    I2cMaster_setup();
+}
 
-    //Set 7-bit slave address
-    I2C_M_SA = slvadd / 2;
+/*! Repeated START (or START) of read phase , 1 byte read needs STOP right after address. */
+static void I2cMaster_startRead(void)
+{
+    unsigned int wait = I2C_M_STT_WAIT;
 
-    //Load transmit pointer & length.
-    I2cMaster_TxPtr = s;
-    I2cMaster_TxCount = len;
-    I2cMaster_NackFlag = 0;
+    I2C_M_CTL1 &= ~UCTR;
+    I2C_M_CTL1 |= UCTXSTT;
+    if (I2cMaster_RxCount == 1)
+    {
+        while ((I2C_M_CTL1 & UCTXSTT) && --wait)
+        {
+            ;
+        }
+        I2C_M_CTL1 |= UCTXSTP;
+    }
+}
 
-    //Send write start.
-    while (I2C_M_CTL1 & UCTXSTP)
-        ;             // Ensure stop condition got sent
-    I2C_M_CTL1 |= UCTR + UCTXSTT;
+/*! Start transaction at Active , transactions past deadline end without bus access. Interrupt disabled. */
+static void I2cMaster_start(void)
+{
+    unsigned int wait = I2C_M_STT_WAIT;
+    tI2cMaster_Xfer *x;
 
-    //Wait ISR to finish transfer with timeout
-    unsigned long timeout = I2C_M_TIMEOUT;
-    while (I2cMaster_TxCount && --timeout)
+    while (I2cMaster_Active != I2cMaster_Head)
     {
-        ;
+        x = &I2cMaster_Queue[I2cMaster_Active & I2C_M_QUEUE_MASK];
+        if ((long) (Clock_getTick() - x->Deadline) < 0)
+        {
+            break;
+        }
+        x->Ret = I2C_MASTER_TIMEOUT;
+        I2cMaster_Stat.Timeout++;
+        I2cMaster_Active++;
     }
-
-    //Return Result.
-    if (timeout == 0)
+    if (I2cMaster_Active == I2cMaster_Head)
     {
-        return I2C_MASTER_TIMEOUT;
+        return;
     }
 
-    if (I2cMaster_NackFlag)
+    I2cMaster_TxPtr = x->Tx;
+    I2cMaster_TxCount = x->TxLen;
+    I2cMaster_RxPtr = x->Rx;
+    I2cMaster_RxCount = x->RxLen;
+
+    //Previous STOP still going out.
+    while ((I2C_M_CTL1 & UCTXSTP) && --wait)
     {
-        return I2C_MASTER_NACK;
+        ;
+    }
+    //Arbitration lost clears UCMST , CTL0 is only written in reset , which also clears interrupt enables.
+    if (!(I2C_M_CTL0 & UCMST))
+    {
+        I2cMaster_setup();
+    }
+    I2C_M_SA = x->SlvAdd / 2;                   // Set 7-bit slave address
+    if (I2cMaster_TxCount)
+    {
+        I2C_M_CTL1 |= UCTR + UCTXSTT;
+    }
+    else
+    {
+        I2cMaster_startRead();
     }
-
-    return I2C_MASTER_SUCCESS;
 }
 
-I2C_MASTER_RET I2cMaster_read(unsigned char slvadd, unsigned char *s, unsigned int len)
+/*! End transaction on bus & start next. Interrupt disabled. */
+static void I2cMaster_finish(I2C_MASTER_RET ret)
 {
-    //Check parameter.
-    if ((s == 0) || (len == 0))
+    I2cMaster_Queue[I2cMaster_Active & I2C_M_QUEUE_MASK].Ret = ret;
+    switch (ret)
     {
-        return I2C_MASTER_FAIL;
+    case I2C_MASTER_SUCCESS:
+        I2cMaster_Stat.Done++;
+        break;
+    case I2C_MASTER_NACK:
+        I2cMaster_Stat.Nack++;
+        break;
+    case I2C_MASTER_TIMEOUT:
+        I2cMaster_Stat.Timeout++;
+        break;
+    default:
+        I2cMaster_Stat.ArbLost++;
+        break;
     }
+    I2cMaster_TxCount = 0;
+    I2cMaster_RxCount = 0;
+    I2cMaster_Active++;
+    I2cMaster_start();
+}
 
-    //Set 7-bit slave address
-    I2C_M_SA = slvadd / 2;
+static void I2cMaster_doneSync(I2C_MASTER_RET ret, void *arg)
+{
+    *(volatile I2C_MASTER_RET *) arg = ret;
+}
 
-    //Load transmit pointer & length.
-    I2cMaster_RxPtr = s;
-    I2cMaster_RxCount = len;
-    I2cMaster_NackFlag = 0;
+/*! Queue & wait , blocking API. */
+static I2C_MASTER_RET I2cMaster_sync(unsigned char slvadd, const unsigned char *tx, unsigned int txlen,
+        unsigned char *rx, unsigned int rxlen)
+{
+    volatile I2C_MASTER_RET ret = I2C_MASTER_BUSY;
 
-    //Send read start.
-    I2C_M_CTL1 &= ~UCTR;
-    if (len == 1)
+    if (I2cMaster_submit(slvadd, tx, txlen, rx, rxlen, I2C_M_TIMEOUT_MS, I2cMaster_doneSync, (void *) &ret)
+            != I2C_MASTER_SUCCESS)
     {
-        while (I2C_M_CTL1 & UCTXSTP)
-            ;             // Ensure stop condition got sent
-        I2C_M_CTL1 |= UCTXSTT;                    // I2C start condition
-        while (I2C_M_CTL1 & UCTXSTT)
-            ;              // Start condition sent?
-        I2C_M_CTL1 |= UCTXSTP;                    // I2C stop condition
+        return I2C_MASTER_FAIL;
     }
-    else
+    while (ret == I2C_MASTER_BUSY)
     {
-        while (I2C_M_CTL1 & UCTXSTP)
-            ;             // Ensure stop condition got sent
-        I2C_M_CTL1 |= UCTXSTT;
-    }
-
-    //Wait ISR to finish transfer with timeout
-    unsigned long timeout = I2C_M_TIMEOUT;
-    while (I2cMaster_RxCount && --timeout)
-    {
-        ;
+        I2cMaster_service();
     }
+    return ret;
+}
 
-    //Return Result.
-    if (timeout == 0)
+void I2cMaster_init(unsigned long clk)
+{
+    if (clk > I2C_M_CLK_MAX)
     {
-        return I2C_MASTER_TIMEOUT;
+        clk = I2C_M_CLK_MAX;
     }
-
-    if (I2cMaster_NackFlag)
+    I2cMaster_Clk = clk;
+    //Round up , SCL never above clk. SMCLK 16.78MHz : 100kHz BR = 168 , 400kHz BR = 42.
+    I2cMaster_Br = (SMCLK_F + clk - 1) / clk;
+    if (I2cMaster_Br < I2C_M_BR_MIN)
     {
-        return I2C_MASTER_NACK;
+        I2cMaster_Br = I2C_M_BR_MIN;
     }
+    I2cMaster_setup();
+}
 
-    return I2C_MASTER_SUCCESS;
+unsigned long I2cMaster_getClk(void)
+{
+    return SMCLK_F / I2cMaster_Br;
 }
 
-I2C_MASTER_RET I2cMaster_wread(unsigned char slvadd, unsigned char *tx, unsigned int txlen, unsigned char *rx,
-        unsigned int rxlen)
+I2C_MASTER_RET I2cMaster_submit(unsigned char slvadd, const unsigned char *tx, unsigned int txlen, unsigned char *rx,
+        unsigned int rxlen, unsigned int timeout_ms, I2cMaster_Done done, void *arg)
 {
+    tI2cMaster_Xfer *x;
+
     //Check parameter.
-    if ((tx == 0) || (txlen == 0) || (rx == 0) || (rxlen == 0))
+    if (((txlen == 0) && (rxlen == 0)) || (txlen && (tx == 0)) || (rxlen && (rx == 0)))
     {
         return I2C_MASTER_FAIL;
     }
 
-    //Set 7-bit slave address
-    I2C_M_SA = slvadd / 2;
-
-    //Load transmit & receive pointer & length.
-    I2cMaster_TxPtr = tx;
-    I2cMaster_TxCount = txlen;
-    I2cMaster_RxPtr = rx;
-    I2cMaster_RxCount = rxlen;
-    I2cMaster_NackFlag = 0;
-
-    //[ Write ] : Send write start.
-    while (I2C_M_CTL1 & UCTXSTP)
-        ;
-    I2C_M_CTL1 |= UCTR + UCTXSTT;
-
-    //[ Write ] : Wait ISR to finish transfer with timeout
-    unsigned long timeout = I2C_M_TIMEOUT;
-    while (I2cMaster_TxCount && --timeout)
+    unsigned short gie = __get_interrupt_state();
+    __disable_interrupt();
+    if ((unsigned char) (I2cMaster_Head - I2cMaster_Tail) >= I2C_M_QUEUE_SIZE)
     {
-        ;
+        I2cMaster_Stat.QueueFull++;
+        __set_interrupt_state(gie);
+        return I2C_MASTER_BUSY;
     }
 
-    //[ Write ] : Return Result if Error happen.
-    if (timeout == 0)
+    x = &I2cMaster_Queue[I2cMaster_Head & I2C_M_QUEUE_MASK];
+    x->SlvAdd = slvadd;
+    x->Tx = tx;
+    x->TxLen = txlen;
+    x->Rx = rx;
+    x->RxLen = rxlen;
+    x->Deadline = Clock_getTick() + CLOCK_MS_TO_TICK(timeout_ms);
+    x->Done = done;
+    x->Arg = arg;
+    x->Ret = I2C_MASTER_BUSY;
+    I2cMaster_Head++;
+    if ((unsigned char) (I2cMaster_Head - I2cMaster_Tail) > I2cMaster_Stat.MaxQueue)
     {
-        return I2C_MASTER_TIMEOUT;
+        I2cMaster_Stat.MaxQueue = I2cMaster_Head - I2cMaster_Tail;
     }
 
-    if (I2cMaster_NackFlag)
+    //Bus idle , start now.
+    if ((unsigned char) (I2cMaster_Head - I2cMaster_Active) == 1)
     {
-        return I2C_MASTER_NACK;
+        I2cMaster_start();
     }
+    __set_interrupt_state(gie);
+    return I2C_MASTER_SUCCESS;
+}
 
-    //[ Read ] : Send read start
-    __delay_cycles(10000);
-    I2C_M_CTL1 &= ~UCTR;
-    I2C_M_CTL1 |= UCTXSTT;                    // I2C start condition
+void I2cMaster_service(void)
+{
+    tI2cMaster_Xfer *x;
+    unsigned char expired = 0;
 
-    if (rxlen == 1)
+    //Deadline of transaction on bus , stop USCI interrupt by reset before recovery.
+    unsigned short gie = __get_interrupt_state();
+    __disable_interrupt();
+    if (I2cMaster_Active != I2cMaster_Head)
     {
-        while (I2C_M_CTL1 & UCTXSTT)
-            ;              // Start condition sent?
-        I2C_M_CTL1 |= UCTXSTP;                    // I2C stop condition
+        x = &I2cMaster_Queue[I2cMaster_Active & I2C_M_QUEUE_MASK];
+        if ((long) (Clock_getTick() - x->Deadline) >= 0)
+        {
+            I2C_M_CTL1 |= UCSWRST;
+            expired = 1;
+        }
     }
+    __set_interrupt_state(gie);
 
-    //[ Read ] : Wait ISR to finish receive with timeout
-    timeout = I2C_M_TIMEOUT;
-    while (I2cMaster_RxCount && --timeout)
+    if (expired)
     {
-        ;
+        I2cMaster_recover();
+        __disable_interrupt();
+        I2cMaster_finish(I2C_MASTER_TIMEOUT);
+        __set_interrupt_state(gie);
     }
 
-    //[ Read ] : Return Result.
-    if (timeout == 0)
+    //Callbacks in main loop context.
+    while (I2cMaster_Tail != I2cMaster_Active)
     {
-        return I2C_MASTER_TIMEOUT;
+        x = &I2cMaster_Queue[I2cMaster_Tail & I2C_M_QUEUE_MASK];
+        if (x->Done)
+        {
+            x->Done(x->Ret, x->Arg);
+        }
+        I2cMaster_Tail++;
     }
+}
+
+unsigned char I2cMaster_isBusy(void)
+{
+    return I2cMaster_Tail != I2cMaster_Head;
+}
+
+tI2cMaster_Stat *I2cMaster_getStat(void)
+{
+    return &I2cMaster_Stat;
+}
 
-    if (I2cMaster_NackFlag)
+I2C_MASTER_RET I2cMaster_write(unsigned char slvadd, unsigned char *s, unsigned int len)
+{
+    return I2cMaster_sync(slvadd, s, len, 0, 0);
+}
+
+I2C_MASTER_RET I2cMaster_read(unsigned char slvadd, unsigned char *s, unsigned int len)
+{
+    return I2cMaster_sync(slvadd, 0, 0, s, len);
+}
+
+I2C_MASTER_RET I2cMaster_wread(unsigned char slvadd, unsigned char *tx, unsigned int txlen, unsigned char *rx,
+        unsigned int rxlen)
+{
+    //Check parameter.
+    if ((txlen == 0) || (rxlen == 0))
     {
-        return I2C_MASTER_NACK;
+        return I2C_MASTER_FAIL;
     }
-
-    return I2C_MASTER_SUCCESS;
+    return I2cMaster_sync(slvadd, tx, txlen, rx, rxlen);
 }
 
 #if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
@@ -397,30 +807,32 @@ void __attribute__ ((interrupt(I2C_M_VECTOR))) I2cMaster_Isr (void)
     {
     case 0: // Vector  0: No interrupts
         break;
-    case 2: // Vector  2: ALIFG
+    case 2: // Vector  2: ALIFG , USCI falls back to slave.
+        I2cMaster_finish(I2C_MASTER_FAIL);
         break;
     case 4: // Vector  4: NACKIFG
-        I2cMaster_RxCount = 0;
-        I2cMaster_TxCount = 0;
         I2C_M_CTL1 |= UCTXSTP;
-        I2cMaster_NackFlag = 1;
+        I2cMaster_finish(I2C_MASTER_NACK);
         break;
     case 6: // Vector  6: STTIFG
         break;
     case 8: // Vector  8: STPIFG
         break;
     case 10: // Vector 10: RXIFG
+        if (I2cMaster_RxCount == 0)
+        {
+            I2C_M_IFG &= ~UCRXIFG;
+            break;
+        }
         I2cMaster_RxCount--;
-        if (I2cMaster_RxCount)
+        *I2cMaster_RxPtr++ = I2C_M_RXBUF;
+        if (I2cMaster_RxCount == 1)
         {
-            *I2cMaster_RxPtr++ = I2C_M_RXBUF;
-            if (I2cMaster_RxCount == 1)
-                I2C_M_CTL1 |= UCTXSTP;
+            I2C_M_CTL1 |= UCTXSTP;
         }
-        else
+        else if (I2cMaster_RxCount == 0)
         {
-            *I2cMaster_RxPtr = I2C_M_RXBUF;
-            I2C_M_IFG &= ~UCRXIFG;
+            I2cMaster_finish(I2C_MASTER_SUCCESS);
         }
         break;
     case 12: // Vector 12: TXIFG
@@ -431,12 +843,18 @@ void __attribute__ ((interrupt(I2C_M_VECTOR))) I2cMaster_Isr (void)
         }
         else
         {
-            if (I2cMaster_RxCount == 0)
+            I2C_M_IFG &= ~UCTXIFG;
+            if (I2cMaster_RxCount)
             {
-                I2C_M_CTL1 |= UCTXSTP;  // Stop condition only when not need restart.
+                I2cMaster_startRead();              // Restart for read phase.
+            }
+            else if (I2cMaster_Active != I2cMaster_Head)
+            {
+                I2C_M_CTL1 |= UCTXSTP;
+                I2cMaster_finish(I2C_MASTER_SUCCESS);
             }
-            I2C_M_IFG &= ~UCTXIFG;
         }
+        break;
     default:
         break;
     }
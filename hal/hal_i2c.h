@@ -13,41 +13,144 @@
 
 #include <msp430.h>
 
+/* I2C Slave register map , 16bit register address (high byte first) , auto increment.
+ * Write : [S] [SLA+W] [ADDR_H] [ADDR_L] [Data ...] [P]
+ * Read  : [S] [SLA+W] [ADDR_H] [ADDR_L] [Sr] [SLA+R] [Data ...] [P]
+ * Data is served by ISR straight from memory windows set by I2cSlave_setWindow , no copy.
+ * Reading across a window end continues in the window at next address , unmapped bytes read 0xFF.
+ * Mailbox at I2C_S_MBOX_ADDR : write = received buffer (I2cSlave_gets) , read = transmit buffer (I2cSlave_puts).
+ * I2C_S_DMA_ENABLE = 1 : address bytes & window ends are handled by ISR , data inside a window is moved by
+ * DMA1 (RX) / DMA2 (TX) on USCI trigger , 1 interrupt per window instead of 1 per byte.
+ * SCL is stretched by USCI while RXBUF is full / TXBUF is empty , slow ISR only lowers bus throughput.
+ */
+#define I2C_S_MBOX_ADDR     0x0000
+#define I2C_S_MBOX_SIZE     256     //Mailbox bytes each direction , RAM = 2 x size.
+#define I2C_S_DMA_ENABLE    1       //1 : Window data by DMA1 / DMA2  0 : by ISR.
+#define I2C_S_DMA_MIN       4       //Window bytes left to start DMA , shorter is done by ISR.
+
+#define I2C_S_WIN_READ      0x01
+#define I2C_S_WIN_WRITE     0x02
+
+typedef struct tI2cSlave_Window
+{
+    unsigned int Addr;          //First register address.
+    unsigned int Size;          //Bytes.
+    void *Data;                 //Memory of the window , read / written by I2C ISR.
+    unsigned char Access;       //I2C_S_WIN_READ / I2C_S_WIN_WRITE.
+} tI2cSlave_Window;
+
+typedef struct tI2cSlave_Stat
+{
+    unsigned long RxByte;       //Bytes written by master , address bytes not included.
+    unsigned long TxByte;       //Bytes read by master , including 1 byte prefetched by USCI at the end.
+    unsigned long DmaByte;      //Bytes of RxByte + TxByte moved by DMA.
+    unsigned int Transfer;      //START & repeated START addressed to slave.
+} tI2cSlave_Stat;
+
 /*!@brief   Initialize I2C Slave.
  * @param   slave_add   :[0~0x7F] Slave address in 7bit.
  */
 extern void I2cSlave_init(unsigned char slave_add);
 
+/*!@brief   Map memory windows to register address , table is used by ISR & must stay valid.
+ * @param   win     : is the pointer to window table , windows must not overlap mailbox or each other.
+ * @param   amount  : is the number of windows.
+ */
+extern void I2cSlave_setWindow(const tI2cSlave_Window *win, unsigned char amount);
+
 /*!@brief   Return 1 byte (the last received) from I2C .
  */
 extern unsigned char I2cSlave_getc(void);
 
-/*!@brief   Put 1 char to I2C Slave , wait master to read.
+/*!@brief   Put 1 char to I2C Slave mailbox , wait master to read.
  * @param   c   : 1 byte of data.
  */
 extern void I2cSlave_putc(unsigned char c);
 
-/*!@brief   Copy I2C received data out.
+/*!@brief   Copy data of the last mailbox write out , data is returned once.
  *
- * @param   s   : is the pointer of buffer to copy I2C data.
+ * @param   s   : is the pointer of buffer to copy I2C data , I2C_S_MBOX_SIZE bytes.
  * @return  len : the length of bytes received.
  *          0x00: No Data received or I2C is busy.
  */
 extern unsigned int I2cSlave_gets(unsigned char *s);
 
-/*!@brief   Put multiple bytes to I2C Slave , wait master to read.
+/*!@brief   Put multiple bytes to I2C Slave mailbox , wait master to read.
  * @param   s   : is the pointer to data.
- * @param   len : is the length of data.
+ * @param   len : is the length of data , cut at I2C_S_MBOX_SIZE.
  */
 extern void I2cSlave_puts(unsigned char *s, unsigned int len);
 
+/*!@brief   Return pointer to I2C slave statistics , byte counters for throughput measure.
+ */
+extern tI2cSlave_Stat *I2cSlave_getStat(void);
+
+#define I2C_M_QUEUE_SIZE    8       //Queued transactions , power of 2.
+#define I2C_M_TIMEOUT_MS    20      //Deadline of blocking I2cMaster_write / read / wread.
+#define I2C_M_CLK_MAX       400000  //USCI_B fSCL limit of MSP430F5529 datasheet , Fast-mode Plus not supported.
+
 typedef enum I2C_MASTER_RET
 {
-    I2C_MASTER_SUCCESS = 0x00, I2C_MASTER_FAIL = 0x01 ,I2C_MASTER_TIMEOUT = 0x02, I2C_MASTER_NACK = 0x03
+    I2C_MASTER_SUCCESS = 0x00, I2C_MASTER_FAIL = 0x01 ,I2C_MASTER_TIMEOUT = 0x02, I2C_MASTER_NACK = 0x03,
+    I2C_MASTER_BUSY = 0x04
 } I2C_MASTER_RET;
 
+/*!@brief   Completion callback of queued transaction , called by I2cMaster_service().
+ * @param   ret : I2C_MASTER_SUCCESS / NACK / TIMEOUT / FAIL (arbitration lost).
+ * @param   arg : is the arg given to I2cMaster_submit.
+ */
+typedef void (*I2cMaster_Done)(I2C_MASTER_RET ret, void *arg);
+
+typedef struct tI2cMaster_Stat
+{
+    unsigned int Done;          //Transactions finished without error.
+    unsigned int Nack;          //Address or data not acknowledged.
+    unsigned int Timeout;       //Deadline passed.
+    unsigned int ArbLost;       //Arbitration lost.
+    unsigned int Recover;       //Bus recoveries , SCL pulses & STOP after timeout.
+    unsigned int QueueFull;     //Submits rejected.
+    unsigned char MaxQueue;     //Peak queued transactions.
+} tI2cMaster_Stat;
+
+/*!@brief   Initialize I2C master.
+ * @param   clk : SCL frequency , cut at I2C_M_CLK_MAX , rounded down to SMCLK / BR.
+ * @note    Clock stretching by slave is followed by USCI , a slave holding SCL too long ends at transaction deadline.
+ */
 void I2cMaster_init(unsigned long clk);
 
+/*!@brief   Return actual SCL frequency , SMCLK / BR.
+ */
+unsigned long I2cMaster_getClk(void);
+
+/*!@brief   Queue 1 transaction : write tx , then repeated start & read rx.
+ * @note    Bytes are moved by I2C ISR , the function returns at once.
+ *          Buffers are NOT copied and must stay valid until callback.
+ *          When the deadline passes , transaction ends with I2C_MASTER_TIMEOUT & bus is recovered.
+ * @param   slvadd      : Slave address in 8bit (7bit address << 1).
+ * @param   tx / txlen  : Bytes to write , txlen 0 = read only.
+ * @param   rx / rxlen  : Bytes to read , rxlen 0 = write only.
+ * @param   timeout_ms  : Deadline from now , including queue waiting.
+ * @param   done / arg  : Completion callback , NULL = none.
+ * @return  I2C_MASTER_SUCCESS = queued , I2C_MASTER_BUSY = queue full , I2C_MASTER_FAIL = bad parameter.
+ */
+I2C_MASTER_RET I2cMaster_submit(unsigned char slvadd, const unsigned char *tx, unsigned int txlen, unsigned char *rx,
+        unsigned int rxlen, unsigned int timeout_ms, I2cMaster_Done done, void *arg);
+
+/*!@brief   Check deadline of transaction on bus & run callbacks of finished transactions , call in main loop.
+ */
+void I2cMaster_service(void);
+
+/*!@brief   Return 1 when queued transactions are not finished.
+ */
+unsigned char I2cMaster_isBusy(void);
+
+/*!@brief   Return pointer to I2C master statistics.
+ */
+tI2cMaster_Stat *I2cMaster_getStat(void);
+
+/*!@brief   Blocking transactions , queued & waited until finished or I2C_M_TIMEOUT_MS.
+ * @note    Callbacks of other transactions may run while waiting.
+ */
 I2C_MASTER_RET I2cMaster_write(unsigned char slvadd, unsigned char *s, unsigned int len);
 
 I2C_MASTER_RET I2cMaster_read(unsigned char slvadd, unsigned char *s, unsigned int len);
@@ -35,6 +35,7 @@
 #define PWM_OUT_VECTOR0     TIMER2_A0_VECTOR
 #define PWM_OUT_VECTOR1     TIMER2_A1_VECTOR
 #define PWM_OUT_IV          TA2IV
+#define PWM_OUT_TAR         TA2R
 
 #endif
 
@@ -42,6 +43,11 @@
  * [ PWM OUT ]  Internal Variables.
  *****************************************************************************/
 unsigned char PwmOut_RiseEdgeFlag[3];
+unsigned int PwmOut_Duty[3];                    //[x/256] Duty of each channel , kept for period change.
+volatile unsigned int PwmOut_PeriodCount;       //Periods finished , counted at TAR = 0.
+volatile unsigned char PwmOut_SyncPending;      //Staged values waiting for period boundary.
+unsigned int PwmOut_SyncCcr[3];                 //Staged CCR0~2.
+unsigned int PwmOut_SyncCctl[3];                //Staged CCTL0~2.
 
 /*****************************************************************************
  * [ PWM OUT ]  External Functions.
@@ -77,6 +83,20 @@ void __attribute__ ((interrupt(PWM_OUT_VECTOR1))) PwmOut_Isr1 (void)
     case 4:          //TA2.2 P2.5
         PwmOut_RiseEdgeFlag[2] = 1;
         break;
+    case 14:         //Over Flow , TAR = 0 , period boundary.
+        if (PwmOut_SyncPending)
+        {
+            //TAR just restarts counting up , all new compare values are still ahead.
+            PWM_OUT_CCR0 = PwmOut_SyncCcr[0];
+            PWM_OUT_CCR1 = PwmOut_SyncCcr[1];
+            PWM_OUT_CCR2 = PwmOut_SyncCcr[2];
+            PWM_OUT_CCTL0 = PwmOut_SyncCctl[0];
+            PWM_OUT_CCTL1 = PwmOut_SyncCctl[1];
+            PWM_OUT_CCTL2 = PwmOut_SyncCctl[2];
+            PwmOut_SyncPending = 0;
+        }
+        PwmOut_PeriodCount++;
+        break;
     default:
         break;
     }
@@ -100,6 +120,11 @@ void PwmOut_init(void)
 
 void PwmOut_setOutput(unsigned char ch, unsigned int freq, unsigned int duty)
 {
+    if (ch < 3)
+    {
+        PwmOut_Duty[ch] = duty;
+    }
+
     switch (ch)
     {
     case 0:
@@ -144,6 +169,70 @@ void PwmOut_setOutput(unsigned char ch, unsigned int freq, unsigned int duty)
     }
 }
 
+unsigned char PwmOut_setOutputSync(unsigned char ch, unsigned int freq, unsigned int duty)
+{
+    unsigned int ccr0;
+    static const unsigned int outmod[3] = { OUTMOD_4, OUTMOD_6, OUTMOD_6 };
+
+    /* Apply at once when nothing to tear :
+     * Timer stopped (CCR0 = 0) , or all outputs disabled , or output to be disabled.
+     */
+    if ((freq == 0) || (ch > 2) || (PWM_OUT_CCR0 == 0)
+            || !((PWM_OUT_CCTL0 | PWM_OUT_CCTL1 | PWM_OUT_CCTL2) & OUTMOD_7))
+    {
+        PwmOut_SyncPending = 0;
+        PwmOut_setOutput(ch, freq, duty);
+        return 0;
+    }
+
+    //Hold ISR while staged values are rewritten.
+    PwmOut_SyncPending = 0;
+
+    //All channels share CCR0 , rescale the other channels to keep their duty.
+    ccr0 = ACLK_F / freq / 2;
+    PwmOut_Duty[ch] = duty;
+    PwmOut_SyncCcr[0] = ccr0;
+    PwmOut_SyncCcr[1] = (unsigned long) ccr0 * PwmOut_Duty[1] / 256;
+    PwmOut_SyncCcr[2] = (unsigned long) ccr0 * (256 - PwmOut_Duty[2]) / 256;
+    PwmOut_SyncCctl[0] = PWM_OUT_CCTL0;
+    PwmOut_SyncCctl[1] = PWM_OUT_CCTL1;
+    PwmOut_SyncCctl[2] = PWM_OUT_CCTL2;
+    PwmOut_SyncCctl[ch] = outmod[ch] + CCIE;
+
+    PwmOut_SyncPending = 1;
+    return 1;
+}
+
+unsigned char PwmOut_isSyncPending(void)
+{
+    return PwmOut_SyncPending;
+}
+
+unsigned int PwmOut_getPeriodCount(void)
+{
+    return PwmOut_PeriodCount;
+}
+
+unsigned int PwmOut_getCount(void)
+{
+    return PWM_OUT_TAR;
+}
+
+unsigned int PwmOut_getCompare(unsigned char ch)
+{
+    switch (ch)
+    {
+    case 0:
+        return PWM_OUT_CCR0;
+    case 1:
+        return PWM_OUT_CCR1;
+    case 2:
+        return PWM_OUT_CCR2;
+    default:
+        return 0;
+    }
+}
+
 unsigned char PwmOut_getRiseEdgeFlag(unsigned char ch)
 {
     if (PwmOut_RiseEdgeFlag[ch])
@@ -26,6 +26,41 @@ extern void PwmOut_init(void);
  */
 extern void PwmOut_setOutput(unsigned char ch, unsigned int freq, unsigned int duty);
 
+/*!@brief   Set PWM output working parameters at the next period boundary (TAR = 0).
+ *          Period & all channels change together , no torn or doubled period is output.
+ *          Duty of the other channels is kept when the period changes.
+ * @note    Applied at once when timer is stopped or all outputs are disabled.
+ *
+ * @param   ch      : [0~2] PWM output channel.
+ * @param   freq    : [Hz] Frequency of PWM , [0] applied at once.
+ * @param   duty    : [x/256] Duty of PWM.
+ * @return  0x01     : Staged , applied at next period boundary.
+ *          0x00     : Applied at once.
+ */
+extern unsigned char PwmOut_setOutputSync(unsigned char ch, unsigned int freq, unsigned int duty);
+
+/*!@brief   Check if staged parameters are waiting for the period boundary.
+ * @return  0x01     : Waiting.
+ *          0x00     : Applied.
+ */
+extern unsigned char PwmOut_isSyncPending(void);
+
+/*!@brief   Get PWM periods finished since initialize , rolls over.
+ */
+extern unsigned int PwmOut_getPeriodCount(void);
+
+/*!@brief   Get PWM timer count , unit in ACLK cycle.
+ *          Counts up from 0 at period boundary to CCR0 , then down to 0.
+ */
+extern unsigned int PwmOut_getCount(void);
+
+/*!@brief   Get compare value of PWM output channel , unit in ACLK cycle.
+ *          Channel 1 & 2 rise when timer counts up to it.
+ *
+ * @param   ch      : [0~2] PWM output channel.
+ */
+extern unsigned int PwmOut_getCompare(unsigned char ch);
+
 /*!@brief   Get PWM out rising edge flag.
  *          When a rising edge has been send, the flag is set to 0x01.
  *          It automatically clears to 0x00 when read.
@@ -10,6 +10,8 @@
 
 #include "hal_spi.h"
 #include "board.h"
+#include "hal_clock.h"
+#include "string.h"
 
 /***[ SPI Slave ] start*******************************************************/
 
@@ -57,14 +59,85 @@
 /*****************************************************************************
  * [ SPI Slave ] Internal Variables.
  *****************************************************************************/
-static unsigned char SpiS_Rxbuf[SPI_S_RX_BUF_SIZE] =
-{ 0 };
+static unsigned char SpiS_Rxbuf[2][SPI_S_RX_BUF_SIZE];
 static unsigned char *SpiS_TxPtr = 0;
 static unsigned int SpiS_TxLen = 0;
 
+//Frame capture , written by CS edge ISR.
+static unsigned char SpiS_Cap = 0;                  //Buffer written by DMA.
+static volatile unsigned char SpiS_Ready = 0;       //1 : Buffer SpiS_Cap ^ 1 holds a finished frame.
+static volatile unsigned char SpiS_Reading = 0;     //1 : SpiSlave_gets copying , buffers are not swapped.
+static unsigned int SpiS_ReadyLen = 0;
+static unsigned long SpiS_ReadyTick = 0;
+static unsigned long SpiS_FrameTick = 0;            //CS end of frame returned by SpiSlave_gets.
+static unsigned long SpiS_LastTick = 0;
+static tSpiSlave_Stat SpiS_Stat;
+
 /*****************************************************************************
  * [ SPI Slave ] Internal Functions.
  *****************************************************************************/
+/*! Restart DMA at the beginning of capture buffer. */
+static void SpiSlave_capture(void)
+{
+    SPI_S_RX_DMACTL &= ~DMAEN;
+    __data16_write_addr((unsigned short) &SPI_S_RX_DMADA, (unsigned long) SpiS_Rxbuf[SpiS_Cap]);
+    SPI_S_RX_DMASZ = SPI_S_RX_BUF_SIZE;
+    /* Single transfer , stops when buffer is full
+     * Source Address  unchanged
+     * Destination Address  increase
+     * Byte transfer
+     * Level Trigger
+     * Enable Transfer*/
+    SPI_S_RX_DMACTL = DMADT_0 + DMASRCINCR_0 + DMADSTINCR_3 + DMASBDB + DMALEVEL + DMAEN;
+}
+
+/* CS rising edge : frame end. DMA stopped by full buffer has DMAEN cleared & DMASZ reloaded. */
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector=SPI_S_CS_IRQ_VECTOR
+__interrupt void SpiSlave_CsIsr(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(SPI_S_CS_IRQ_VECTOR))) SpiSlave_CsIsr (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    unsigned long tick = Clock_getTick();
+    unsigned int len;
+
+    SPI_S_CS_IRQ_IFG &= ~SPI_S_CS_IRQ_PIN;
+    len = (SPI_S_RX_DMACTL & DMAEN) ? SPI_S_RX_BUF_SIZE - SPI_S_RX_DMASZ : SPI_S_RX_BUF_SIZE;
+    if ((len == 0) || !GET_SPI_S_CS_LEVEL)
+    {
+        return;     //CS glitch or pulse without clock.
+    }
+
+    SpiS_Stat.Frame++;
+    SpiS_Stat.Period = tick - SpiS_LastTick;
+    SpiS_LastTick = tick;
+    if (len == SPI_S_RX_BUF_SIZE)
+    {
+        SpiS_Stat.Full++;
+    }
+
+    if (SpiS_Reading)
+    {
+        //Other buffer in use , receive next frame into the same buffer.
+        SpiS_Stat.Drop++;
+    }
+    else
+    {
+        if (SpiS_Ready)
+        {
+            SpiS_Stat.Replace++;
+        }
+        SpiS_ReadyLen = len;
+        SpiS_ReadyTick = tick;
+        SpiS_Ready = 1;
+        SpiS_Cap ^= 1;
+    }
+    SpiSlave_capture();
+}
+
 #if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
 #pragma vector=SPI_S_VECTOR
 __interrupt void SpiSlave_Isr(void)
@@ -120,19 +193,16 @@ void SpiSlave_init(void)
     //Set trigger source = SPI RX
     SPI_S_RX_DMACTL0 &= 0xFF00;
     SPI_S_RX_DMACTL0 |= SPI_S_DMA_RX_TRIG;
-    //Set max transfer size.
-    SPI_S_RX_DMASZ = SPI_S_RX_BUF_SIZE;
     //Source address = USCIxRXBUF
     __data16_write_addr((unsigned short) &SPI_S_RX_DMASA, (unsigned long) &SPI_S_RXBUF);
-    //Destination address = RAM Buffer
-    __data16_write_addr((unsigned short) &SPI_S_RX_DMADA, (unsigned long) &SpiS_Rxbuf);
-    /* Repeated Single transfer
-     * Source Address  unchanged
-     * Destination Address  increase
-     * Byte transfer
-     * Level Trigger
-     * Enable Transfer*/
-    SPI_S_RX_DMACTL = DMADT_4 + DMASRCINCR_0 + DMADSTINCR_3 + DMASBDB + DMALEVEL + DMAEN;
+    //Destination address = capture buffer.
+    SpiSlave_capture();
+
+    /***[3] Initialize CS rising edge interrupt **********************/
+    SPI_S_CS_IRQ_DIR &= ~SPI_S_CS_IRQ_PIN;
+    SPI_S_CS_IRQ_IES &= ~SPI_S_CS_IRQ_PIN;      //Low to high.
+    SPI_S_CS_IRQ_IFG &= ~SPI_S_CS_IRQ_PIN;
+    SPI_S_CS_IRQ_IE |= SPI_S_CS_IRQ_PIN;
 }
 
 void SpiSlave_putc(char c)
@@ -166,25 +236,40 @@ unsigned char SpiSlave_getc(void)
 
 unsigned int SpiSlave_gets(unsigned char *s)
 {
-    if (!GET_SPI_S_CS_LEVEL)
-    {
-        return 0;     //NOT Allow data copy when SPI_CS = L
-    }
+    unsigned int len;
 
-    unsigned int i, len;
-    len = SPI_S_RX_BUF_SIZE - DMA0SZ;
-    for (i = 0; i < len; i++)
+    //Set before checking , ISR does not swap into the buffer being copied.
+    SpiS_Reading = 1;
+    if (!SpiS_Ready)
     {
-        s[i] = SpiS_Rxbuf[i];
+        SpiS_Reading = 0;
+        return 0;
     }
+    len = SpiS_ReadyLen;
+    SpiS_FrameTick = SpiS_ReadyTick;
+    SpiS_Ready = 0;
+    memcpy(s, SpiS_Rxbuf[SpiS_Cap ^ 1], len);
+    SpiS_Reading = 0;
     return len;
 }
 
+unsigned long SpiSlave_getFrameTick(void)
+{
+    return SpiS_FrameTick;
+}
+
+tSpiSlave_Stat *SpiSlave_getStat(void)
+{
+    return &SpiS_Stat;
+}
+
 void SpiSlave_clear(void)
 {
-    //memset(SpiS_Rxbuf, 0x0000, sizeof(SpiS_Rxbuf));
-    SPI_S_RX_DMACTL &= ~DMAEN;
-    SPI_S_RX_DMACTL |= DMAEN;
+    unsigned short gie = __get_interrupt_state();
+    __disable_interrupt();
+    SpiS_Ready = 0;
+    SpiSlave_capture();
+    __set_interrupt_state(gie);
 }
 
 /***[ SPI Master ] start******************************************************/
@@ -235,6 +320,18 @@ P4SEL &= ~BIT0; \
 #define SPI_M_VECTOR            USCI_B1_VECTOR
 #endif
 
+/* CS setup / hold timer , compare channel 0 of the free running tick timer (hal_clock).
+ * CCR0 owns its vector , the tick overflow is on TIMER0_B1_VECTOR.
+ */
+#define SPI_M_CS_TIMER_R        TB0R
+#define SPI_M_CS_TIMER_CCR      TB0CCR0
+#define SPI_M_CS_TIMER_CCTL     TB0CCTL0
+#define SPI_M_CS_TIMER_VECTOR   TIMER0_B0_VECTOR
+#define SPI_M_CS_TICK_MIN       4           //Shortest compare delay , later than ISR entry.
+
+#define SPI_M_CS_PIN_AMOUNT     16
+#define SPI_M_ASYNC_MASK        (SPI_M_ASYNC_QUEUE_SIZE - 1)
+
 #if SPI_MASTER_BASE
 /*****************************************************************************
  * [ SPI Master ] operation buffers.
@@ -242,6 +339,44 @@ P4SEL &= ~BIT0; \
 static unsigned char *Spi_M_RxPtr = 0;
 static unsigned char Spi_M_RxLen = 0;
 
+/*****************************************************************************
+ * [ SPI Master ] CS sequencer.
+ * 1 transfer : CS active -> setup time -> head & data bytes by TX ISR -> hold time -> CS released.
+ * Setup / hold timing is counted by the tick timer compare ISR , CPU is free during the gaps.
+ *****************************************************************************/
+typedef enum
+{
+    SPI_M_SEQ_IDLE = 0,
+    SPI_M_SEQ_SETUP,
+    SPI_M_SEQ_DATA,
+    SPI_M_SEQ_HOLD,
+} SPI_M_SEQ_STATE;
+
+typedef struct tSpi_M_Xfer
+{
+    unsigned int Cs;
+    unsigned int Setup;                             //Ticks.
+    unsigned int Hold;                              //Ticks.
+    unsigned char Head[SPI_M_ASYNC_HEAD_MAX];       //Copied when queued.
+    unsigned char HeadLen;
+    const unsigned char *Data;                      //Not copied , valid until transfer ends.
+    unsigned int Len;
+    unsigned char *RxLast;                          //Last received byte is stored when CS released , 0 = none.
+} tSpi_M_Xfer;
+
+static unsigned int Spi_M_CsSetup[SPI_M_CS_PIN_AMOUNT];     //Ticks , by CS pin.
+static unsigned int Spi_M_CsHold[SPI_M_CS_PIN_AMOUNT];      //Ticks , by CS pin.
+static unsigned int Spi_M_ByteTicks = 1;                    //Ticks of 1 byte on SPI clock.
+static unsigned int Spi_M_CsLast = 0;                       //CS of last synchronous transfer.
+
+static tSpi_M_Xfer Spi_M_Queue[SPI_M_ASYNC_QUEUE_SIZE];
+static volatile unsigned char Spi_M_QHead = 0;              //Written by caller.
+static volatile unsigned char Spi_M_QTail = 0;              //Written by ISR.
+static volatile SPI_M_SEQ_STATE Spi_M_SeqState = SPI_M_SEQ_IDLE;
+static const unsigned char *Spi_M_TxPtr;
+static unsigned int Spi_M_TxLeft;
+static unsigned char Spi_M_TxHeadLeft;
+
 /*****************************************************************************
  * [ SPI Master ] Internal Functions.
  *****************************************************************************/
@@ -270,11 +405,157 @@ void __attribute__ ((interrupt(SPI_M_VECTOR))) SpiMaster_Isr (void)
         }
         break;
         case 4:     // Vector 4 - TXIFG
+        {
+            //Async transfer , head bytes first then data.
+            tSpi_M_Xfer *pxfer = &Spi_M_Queue[Spi_M_QTail & SPI_M_ASYNC_MASK];
+            if (Spi_M_TxHeadLeft)
+            {
+                SPI_M_TXBUF = pxfer->Head[pxfer->HeadLen - Spi_M_TxHeadLeft];
+                Spi_M_TxHeadLeft--;
+            }
+            else if (Spi_M_TxLeft)
+            {
+                SPI_M_TXBUF = *Spi_M_TxPtr++;
+                Spi_M_TxLeft--;
+            }
+            if ((Spi_M_TxHeadLeft == 0) && (Spi_M_TxLeft == 0))
+            {
+                //Last byte in TXBUF , 1 byte in shifter at most. Hold time starts when both are out.
+                SPI_M_IE &= ~UCTXIE;
+                Spi_M_SeqState = SPI_M_SEQ_HOLD;
+                SPI_M_CS_TIMER_CCR = SPI_M_CS_TIMER_R + (Spi_M_ByteTicks << 1) + pxfer->Hold;
+                SPI_M_CS_TIMER_CCTL = CCIE;
+            }
+        }
         break;
         default:
         break;
     }
 }
+
+/*!@fn      SpiMaster_setCsLevel
+ * @brief   Set CS pins without waiting , see SpiMaster_setCsPins.
+ */
+static void SpiMaster_setCsLevel(unsigned int cs_sel)
+{
+#ifdef SET_SPI_M_CS_ALL_LOW     //Set CS_ALL
+    if (cs_sel)
+    {
+        SET_SPI_M_CS_ALL_LOW;     //SET LOW
+    }
+    else
+    {
+        SET_SPI_M_CS_ALL_HIGH;     //GPIO HIGH
+    }
+#endif
+
+#ifdef SPI_M_CS_GRP_L           //Set Low byte CS group ( CS_0~CS7 )
+    //Not selected pins GPIO HIGH , selected pins GPIO LOW , in 1 write.
+    unsigned char lowbyte = cs_sel & 0x00FF;
+    SPI_M_CS_GRP_L = (SPI_M_CS_GRP_L | SPI_M_CS_PIN_L) & ~(SPI_M_CS_PIN_L & lowbyte);
+#endif
+
+#ifdef SPI_M_CS_GRP_H           //Set High byte CS group ( CS_8~CS15 )
+    unsigned char highbyte = (cs_sel >> 8) & 0x00FF;
+    SPI_M_CS_GRP_H = (SPI_M_CS_GRP_H | SPI_M_CS_PIN_H) & ~(SPI_M_CS_PIN_H & highbyte);
+#endif
+}
+
+/*!@fn      SpiMaster_getCsTiming
+ * @brief   Longest setup & hold ticks of selected CS pins.
+ */
+static void SpiMaster_getCsTiming(unsigned int cs_sel, unsigned int *psetup, unsigned int *phold)
+{
+    unsigned char i;
+    unsigned int setup = SPI_M_CS_TICK_MIN;
+    unsigned int hold = SPI_M_CS_TICK_MIN;
+
+    for (i = 0; cs_sel; i++, cs_sel >>= 1)
+    {
+        if (cs_sel & 0x01)
+        {
+            setup = Spi_M_CsSetup[i] > setup ? Spi_M_CsSetup[i] : setup;
+            hold = Spi_M_CsHold[i] > hold ? Spi_M_CsHold[i] : hold;
+        }
+    }
+    *psetup = setup;
+    *phold = hold;
+}
+
+/*!@fn      SpiMaster_waitTicks
+ * @brief   Busy wait on tick timer , for synchronous transfer only.
+ */
+static void SpiMaster_waitTicks(unsigned int ticks)
+{
+    unsigned int start = SPI_M_CS_TIMER_R;
+    while ((unsigned int) (SPI_M_CS_TIMER_R - start) < ticks)
+    {
+        ;
+    }
+}
+
+/*!@fn      SpiMaster_startXfer
+ * @brief   Start queued transfer at queue tail : CS active & setup time counting.
+ * @note    Called with interrupt disabled or from ISR.
+ */
+static void SpiMaster_startXfer(void)
+{
+    if (Spi_M_QTail == Spi_M_QHead)
+    {
+        Spi_M_SeqState = SPI_M_SEQ_IDLE;
+        return;
+    }
+    tSpi_M_Xfer *pxfer = &Spi_M_Queue[Spi_M_QTail & SPI_M_ASYNC_MASK];
+    Spi_M_TxHeadLeft = pxfer->HeadLen;
+    Spi_M_TxPtr = pxfer->Data;
+    Spi_M_TxLeft = pxfer->Len;
+
+    SpiMaster_setCsLevel(pxfer->Cs);
+    Spi_M_SeqState = SPI_M_SEQ_SETUP;
+    SPI_M_CS_TIMER_CCR = SPI_M_CS_TIMER_R + pxfer->Setup;
+    SPI_M_CS_TIMER_CCTL = CCIE;
+}
+
+// CS setup / hold timer ISR
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector=SPI_M_CS_TIMER_VECTOR
+__interrupt void SpiMaster_Cs_Isr(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(SPI_M_CS_TIMER_VECTOR))) SpiMaster_Cs_Isr (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    switch (Spi_M_SeqState)
+    {
+    case SPI_M_SEQ_SETUP:
+        //Setup time passed , TX ISR sends bytes.
+        SPI_M_CS_TIMER_CCTL = 0;
+        Spi_M_SeqState = SPI_M_SEQ_DATA;
+        SPI_M_IE |= UCTXIE;
+        break;
+    case SPI_M_SEQ_HOLD:
+        if (SPI_M_STAT & UCBUSY)
+        {
+            //SPI clock slower than estimated , check again 1 byte later.
+            SPI_M_CS_TIMER_CCR += Spi_M_ByteTicks;
+            break;
+        }
+        //Hold time passed , release CS & start next transfer.
+        SPI_M_CS_TIMER_CCTL = 0;
+        if (Spi_M_Queue[Spi_M_QTail & SPI_M_ASYNC_MASK].RxLast)
+        {
+            *Spi_M_Queue[Spi_M_QTail & SPI_M_ASYNC_MASK].RxLast = SPI_M_RXBUF;
+        }
+        SpiMaster_setCsLevel(0);
+        Spi_M_QTail++;
+        SpiMaster_startXfer();
+        break;
+    default:
+        SPI_M_CS_TIMER_CCTL = 0;
+        break;
+    }
+}
 #endif
 /*****************************************************************************
  * [ SPI Master ] External Functions.
@@ -285,6 +566,15 @@ void SpiMaster_init(unsigned long freq)
     // Set function IO.
     SET_SPI_M_FUNC_IO
     ;
+    // Set CS group pins GPIO output HIGH.
+#ifdef SPI_M_CS_GRP_L
+    SPI_M_CS_GRP_L |= SPI_M_CS_PIN_L;
+    SPI_M_CS_DIR_L |= SPI_M_CS_PIN_L;
+#endif
+#ifdef SPI_M_CS_GRP_H
+    SPI_M_CS_GRP_H |= SPI_M_CS_PIN_H;
+    SPI_M_CS_DIR_H |= SPI_M_CS_PIN_H;
+#endif
     //**Reset**
     SPI_M_CTL1 |= UCSWRST;
     /* SPI MODE
@@ -303,6 +593,10 @@ void SpiMaster_init(unsigned long freq)
     SPI_M_BR1 = br >> 8;
     //**Enable**
     SPI_M_CTL1 &= ~UCSWRST;
+
+    //CS sequencer , default timing on all CS pins.
+    Spi_M_ByteTicks = (unsigned int) (CLOCK_TICK_F * 8 / freq) + 1;
+    SpiMaster_setCsTiming(0xFFFF, SPI_M_CS_SETUP_US, SPI_M_CS_HOLD_US);
 #endif
 }
 
@@ -355,39 +649,100 @@ void SpiMaster_gets(unsigned char *s, unsigned int len)
 
 void SpiMaster_setCsPins(unsigned int cs_sel)
 {
+#if SPI_MASTER_BASE
+    unsigned int setup, hold;
 
-#ifdef SET_SPI_M_CS_ALL_LOW     //Set CS_ALL
     if (cs_sel)
     {
-        SET_SPI_M_CS_ALL_LOW;     //SET LOW
+        //Queued transfers own the bus until finished.
+        SpiMaster_flush();
+        SpiMaster_getCsTiming(cs_sel, &setup, &hold);
+        SpiMaster_setCsLevel(cs_sel);
+        SpiMaster_waitTicks(setup);
     }
     else
     {
-        SET_SPI_M_CS_ALL_HIGH;     //GPIO HIGH
+        SpiMaster_getCsTiming(Spi_M_CsLast, &setup, &hold);
+        SpiMaster_waitTicks(hold);
+        SpiMaster_setCsLevel(0);
     }
+    Spi_M_CsLast = cs_sel;
 #endif
+}
 
-#ifdef SPI_M_CS_GRP_L           //Set Low byte CS group ( CS_0~CS7 )
-    unsigned char lowbyte = cs_sel & 0x00FF;
-    if (lowbyte)
+void SpiMaster_setCsTiming(unsigned int cs_sel, unsigned int setup_us, unsigned int hold_us)
+{
+#if SPI_MASTER_BASE
+    unsigned char i;
+    unsigned int setup = (unsigned int) CLOCK_US_TO_TICK(setup_us);
+    unsigned int hold = (unsigned int) CLOCK_US_TO_TICK(hold_us);
+
+    for (i = 0; i < SPI_M_CS_PIN_AMOUNT; i++)
     {
-        SPI_M_CS_GRP_L &= ~(SPI_M_CS_PIN_L & lowbyte);     //GPIO LOW
+        if (cs_sel & (1 << i))
+        {
+            Spi_M_CsSetup[i] = setup;
+            Spi_M_CsHold[i] = hold;
+        }
     }
-    else
+#endif
+}
+
+void SpiMaster_putsAsync(unsigned int cs_sel, const unsigned char *head, unsigned char head_len,
+                         const unsigned char *s, unsigned int len)
+{
+    SpiMaster_getcAsync(cs_sel, head, head_len, s, len, 0);
+}
+
+void SpiMaster_getcAsync(unsigned int cs_sel, const unsigned char *head, unsigned char head_len,
+                         const unsigned char *s, unsigned int len, unsigned char *last)
+{
+#if SPI_MASTER_BASE
+    //Queue full , wait the oldest transfer to finish.
+    while ((unsigned char) (Spi_M_QHead - Spi_M_QTail) >= SPI_M_ASYNC_QUEUE_SIZE)
     {
-        SPI_M_CS_GRP_L |= (SPI_M_CS_PIN_L & lowbyte);     //GPIO HIGH
+        ;
     }
-#endif
 
-#ifdef SPI_M_CS_GRP_H           //Set High byte CS group ( CS_8~CS15 )
-    unsigned char highbyte = (cs_sel >> 8) & 0x00FF;
-    if (highbyte)
+    tSpi_M_Xfer *pxfer = &Spi_M_Queue[Spi_M_QHead & SPI_M_ASYNC_MASK];
+    if (head_len > SPI_M_ASYNC_HEAD_MAX)
     {
-        SPI_M_CS_GRP_H &= ~(SPI_M_CS_PIN_H & highbyte);     //GPIO LOW
+        head_len = SPI_M_ASYNC_HEAD_MAX;
     }
-    else
+    pxfer->Cs = cs_sel;
+    SpiMaster_getCsTiming(cs_sel, &pxfer->Setup, &pxfer->Hold);
+    memcpy(pxfer->Head, head, head_len);
+    pxfer->HeadLen = head_len;
+    pxfer->Data = s;
+    pxfer->Len = len;
+    pxfer->RxLast = last;
+
+    unsigned short gie = __get_interrupt_state();
+    __disable_interrupt();
+    Spi_M_QHead++;
+    if (Spi_M_SeqState == SPI_M_SEQ_IDLE)
+    {
+        SpiMaster_startXfer();
+    }
+    __set_interrupt_state(gie);
+#endif
+}
+
+unsigned char SpiMaster_isBusy(void)
+{
+#if SPI_MASTER_BASE
+    return Spi_M_SeqState != SPI_M_SEQ_IDLE;
+#else
+    return 0;
+#endif
+}
+
+void SpiMaster_flush(void)
+{
+#if SPI_MASTER_BASE
+    while (Spi_M_SeqState != SPI_M_SEQ_IDLE)
     {
-        SPI_M_CS_GRP_H |= (SPI_M_CS_PIN_H & highbyte);     //GPIO HIGH
+        ;
     }
 #endif
 }
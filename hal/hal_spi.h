@@ -13,7 +13,26 @@
 
 #include "msp430.h"
 
-#define SPI_S_RX_BUF_SIZE       256
+/* SPI slave frame capture :
+ * MOSI bytes are moved by DMA0 into 1 of 2 capture buffers. CS (STE) rising edge interrupt marks the frame end ,
+ * records length & tick , then swaps buffers , the finished frame waits for SpiSlave_gets.
+ * STE has no port interrupt , it is also wired to SPI_S_CS_IRQ_PIN (board.h).
+ */
+#define SPI_S_RX_BUF_SIZE       256         //Bytes of each capture buffer , longer frames are cut.
+
+typedef struct tSpiSlave_Stat
+{
+    unsigned int Frame;         //Frames ended by CS , empty CS pulses not included.
+    unsigned int Drop;          //Frames dropped , SpiSlave_gets copying the other buffer.
+    unsigned int Replace;       //Finished frames replaced by a newer one before SpiSlave_gets.
+    unsigned int Full;          //Frames of SPI_S_RX_BUF_SIZE bytes , may be cut.
+    unsigned long Period;       //Clock_getTick() ticks between last 2 frame ends.
+} tSpiSlave_Stat;
+
+#define SPI_M_ASYNC_QUEUE_SIZE  16          //Queued SPI master transfers , power of 2.
+#define SPI_M_ASYNC_HEAD_MAX    4           //Head bytes copied into queue.
+#define SPI_M_CS_SETUP_US       100         //Default CS active to 1st clock.
+#define SPI_M_CS_HOLD_US        100         //Default last clock to CS release.
 
 /******************************************************************************
  * @fn      SpiSlave_init
@@ -48,24 +67,37 @@ unsigned char SpiSlave_getc(void);
 /******************************************************************************
  * @fn      SpiSlave_gets
  * @brief   SPI slave MOSI received data is buffered to RAM by DMA.
- *          This function copy buffered data out & return the number of byte received.
- * @param   *s   : is the pointer to destination of copy.
- * @return  \b 0 : No byte received or SPI_SLAVE_CS is Low (MOSI is transmitting).
- *          \b 1~255 : Number of byte received.
+ *          This function copy the last frame ended by CS out , each frame is returned once.
+ * @param   *s   : is the pointer to destination of copy , SPI_S_RX_BUF_SIZE bytes.
+ * @return  \b 0 : No new frame.
+ *          \b 1~SPI_S_RX_BUF_SIZE : Number of byte received.
  *****************************************************************************/
 unsigned int SpiSlave_gets(unsigned char *s);
 
+/******************************************************************************
+ * @fn      SpiSlave_getFrameTick
+ * @return  Clock_getTick() at CS end of the frame returned by last SpiSlave_gets.
+ *****************************************************************************/
+unsigned long SpiSlave_getFrameTick(void);
+
+/******************************************************************************
+ * @fn      SpiSlave_getStat
+ * @return  Pointer to SPI slave frame statistics.
+ *****************************************************************************/
+tSpiSlave_Stat *SpiSlave_getStat(void);
+
 /******************************************************************************
  * @fn      SpiSlave_clear
- * @brief   Clear SPi Slave Received buffer, reset DMA .
+ * @brief   Drop finished frame , restart capture of current buffer.
+ * @note    A frame being received is cut , call only to resynchronize.
  *****************************************************************************/
 void SpiSlave_clear(void);
 
 /******************************************************************************
  * @fn      SpiMaster_init
  * @brief   Initialize SPI Master.
- * @note    SPI_M_CS_ALL pin is set to GPIO output by this function.
- *          Other SPI_M_CS pins need to be initialized as GPIO output elsewhere.
+ * @note    SPI_M_CS_ALL pin & SPI_M_CS_GRP_L / SPI_M_CS_GRP_H pins (board.h) are set to GPIO output
+ *          by this function.
  *****************************************************************************/
 void SpiMaster_init(unsigned long freq);
 
@@ -106,9 +138,59 @@ void SpiMaster_gets(unsigned char *s, unsigned int len);
 /******************************************************************************
  * @fn      SpiMaster_setCsPins
  * @brief   Set select CS pins to active state.
- * @param   cs_sel : Each bit of cs_sel indicates 1 SPI_M_CS pin.
+ * @param   cs_sel : Each bit of cs_sel indicates 1 SPI_M_CS pin , not selected pins are released.
+ *                   CS_0~CS7 on SPI_M_CS_GRP_L , CS_8~CS15 on SPI_M_CS_GRP_H.
  *                   SPI_M_CS_ALL is set when any bit is 1.
+ * @note    Synchronous transfer : waits queued transfers , then CS setup time after active ,
+ *          CS hold time before release (cs_sel = 0).
  *****************************************************************************/
 void SpiMaster_setCsPins(unsigned int cs_sel);
 
+/******************************************************************************
+ * @fn      SpiMaster_setCsTiming
+ * @brief   Set CS setup & hold time of selected CS pins , default SPI_M_CS_SETUP_US / SPI_M_CS_HOLD_US.
+ * @note    Transfer to several CS pins uses the longest time of them.
+ * @param   cs_sel   : Each bit of cs_sel indicates 1 SPI_M_CS pin , same as SpiMaster_setCsPins.
+ * @param   setup_us : CS active to 1st clock , unit in us.
+ * @param   hold_us  : Last clock to CS release , unit in us.
+ *****************************************************************************/
+void SpiMaster_setCsTiming(unsigned int cs_sel, unsigned int setup_us, unsigned int hold_us);
+
+/******************************************************************************
+ * @fn      SpiMaster_putsAsync
+ * @brief   Queue 1 transfer : CS active , setup time , head & data , hold time , CS released.
+ * @note    Setup / hold time is counted by timer ISR , byte transfer by SPI TX ISR ,
+ *          the function returns at once unless the queue is full.
+ *          Head is copied , data is NOT copied and must stay unchanged until SpiMaster_isBusy() returns 0.
+ *          SpiMaster_setCsPins waits queued transfers to finish.
+ * @param   cs_sel   : CS pins , same as SpiMaster_setCsPins.
+ * @param   *head    : is the pointer to head bytes (e.g. command & address) , up to SPI_M_ASYNC_HEAD_MAX.
+ * @param   head_len : is the size of head.
+ * @param   *s       : is the pointer to data bytes after head.
+ * @param   len      : is the size of data.
+ *****************************************************************************/
+void SpiMaster_putsAsync(unsigned int cs_sel, const unsigned char *head, unsigned char head_len,
+                         const unsigned char *s, unsigned int len);
+
+/******************************************************************************
+ * @fn      SpiMaster_getcAsync
+ * @brief   Queue 1 transfer same as SpiMaster_putsAsync , keep the last received byte (e.g. register read).
+ * @param   *last    : is the pointer to the last received byte , written when CS released.
+ *                     Valid after SpiMaster_flush() or SpiMaster_isBusy() returns 0.
+ *****************************************************************************/
+void SpiMaster_getcAsync(unsigned int cs_sel, const unsigned char *head, unsigned char head_len,
+                         const unsigned char *s, unsigned int len, unsigned char *last);
+
+/******************************************************************************
+ * @fn      SpiMaster_isBusy
+ * @return  1 : Queued transfer not finished , 0 : Idle.
+ *****************************************************************************/
+unsigned char SpiMaster_isBusy(void);
+
+/******************************************************************************
+ * @fn      SpiMaster_flush
+ * @brief   Wait all queued transfers to finish.
+ *****************************************************************************/
+void SpiMaster_flush(void);
+
 #endif /* HAL_HAL_SPI_H_ */
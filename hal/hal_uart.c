@@ -33,6 +33,7 @@
 #define UART_BR0            UCA0BR0
 #define UART_BR1            UCA0BR1
 #define UART_MCTL           UCA0MCTL
+#define UART_STAT           UCA0STAT
 #define UART_IE             UCA0IE
 #define UART_IFG            UCA0IFG
 #define UART_IV             UCA0IV
@@ -47,6 +48,7 @@
 #define UART_BR0            UCA1BR0
 #define UART_BR1            UCA1BR1
 #define UART_MCTL           UCA1MCTL
+#define UART_STAT           UCA1STAT
 #define UART_IE             UCA1IE
 #define UART_IFG            UCA1IFG
 #define UART_IV             UCA1IV
@@ -58,9 +60,39 @@
 /*****************************************************************************
  * Internal Variables
  *****************************************************************************/
-unsigned char Uart_RxBuffer[UART_RX_BUF_SIZE] =
-{ 0 };
-unsigned char Uart_RxCount = 0;
+#define UART_RX_MASK        (UART_RX_BUF_SIZE - 1)
+#define UART_RX_LINE_MASK   (UART_RX_LINE_MAX - 1)
+#define UART_TX_MASK        (UART_TX_BUF_SIZE - 1)
+
+/* RX ring , single producer (ISR) & single consumer (main loop).
+ * Each index is written by 1 side only , no interrupt lock is needed.
+ */
+static unsigned char Uart_RxBuffer[UART_RX_BUF_SIZE];
+static volatile unsigned int Uart_RxHead = 0;                    //Free running , written by ISR.
+static volatile unsigned int Uart_RxTail = 0;                    //Free running , written by consumer.
+static volatile unsigned int Uart_RxLineEnd[UART_RX_LINE_MAX];   //Head after each line end , written by ISR.
+static volatile unsigned char Uart_RxLineHead = 0;               //Written by ISR.
+static volatile unsigned char Uart_RxLineTail = 0;               //Written by consumer.
+static tUart_RxStat Uart_RxStat;
+
+//Echo bytes , written by RX ISR & sent first by TX ISR , never mixed with TX ring writes of main loop.
+#define UART_ECHO_BUF_SIZE  16
+static unsigned char Uart_EchoBuffer[UART_ECHO_BUF_SIZE];
+static unsigned char Uart_EchoHead = 0;
+static unsigned char Uart_EchoTail = 0;
+
+static unsigned char Uart_TxBuffer[UART_TX_BUF_SIZE];
+static volatile unsigned int Uart_TxHead = 0;       //Free running , written by caller.
+static volatile unsigned int Uart_TxTail = 0;       //Free running , written by ISR.
+static volatile unsigned int Uart_TxSkip = 0;       //Free running , written by caller , ISR moves tail here when behind.
+static UART_TX_POLICY Uart_TxPolicy = UART_TX_POLICY_DEFAULT;
+static tUart_TxStat Uart_TxStat;
+
+static tUart_Baud Uart_Baud;
+
+//UCBRSx modulation pattern , bit n = 1 : UART bit n (0 = start bit) is 1 BITCLK longer.
+static const unsigned char UART_BRS_PATTERN[8] = { 0x00, 0x02, 0x22, 0x2A, 0xAA, 0xAE, 0xEE, 0xFE };
+#define UART_FRAME_BIT      10      //Start + 8 data + stop.
 
 /*****************************************************************************
  * Internal Functions
@@ -80,116 +112,437 @@ void __attribute__ ((interrupt(UART_VECTOR))) Uart_Isr (void)
     case 0: // Vector 0 - no interrupt
         break;
     case 2: // Vector 2 - RXIFG
-        //Loop back function
-        while (!(UART_IFG & UCTXIFG))
+    {
+        unsigned char byte = UART_RXBUF;
+        unsigned int used = Uart_RxHead - Uart_RxTail;
+
+#if UART_RX_ECHO
+        //Loop back through TX ISR , dropped when echo buffer is full.
+        if ((unsigned char) (Uart_EchoHead - Uart_EchoTail) < UART_ECHO_BUF_SIZE)
+        {
+            Uart_EchoBuffer[Uart_EchoHead % UART_ECHO_BUF_SIZE] = byte;
+            Uart_EchoHead++;
+            UART_IE |= UCTXIE;
+        }
+        else
         {
-            ;
+            Uart_TxStat.DropByte++;
         }
-        UART_TXBUF = UART_RXBUF;
+#endif
 
         //Buffer received data.
-        Uart_RxBuffer[Uart_RxCount++] = UART_RXBUF;
+        if (used >= UART_RX_BUF_SIZE)
+        {
+            Uart_RxStat.DropByte++;
+            break;
+        }
+        Uart_RxBuffer[Uart_RxHead & UART_RX_MASK] = byte;
+        Uart_RxHead++;
+
+        //Record line end , a full ring without line end is cut as 1 line.
+        if ((byte == '\r') || (used + 1 == UART_RX_BUF_SIZE))
+        {
+            if (byte != '\r')
+            {
+                Uart_RxStat.LineCut++;
+            }
+            if ((unsigned char) (Uart_RxLineHead - Uart_RxLineTail) < UART_RX_LINE_MAX)
+            {
+                Uart_RxLineEnd[Uart_RxLineHead & UART_RX_LINE_MASK] = Uart_RxHead;
+                Uart_RxLineHead++;
+            }
+            else
+            {
+                Uart_RxStat.LineDrop++;
+            }
+        }
         break;
+    }
     case 4: // Vector 4 - TXIFG
+        //Echo first , then drain TX ring , disable TX interrupt when both empty.
+        if (Uart_EchoTail != Uart_EchoHead)
+        {
+            UART_TXBUF = Uart_EchoBuffer[Uart_EchoTail % UART_ECHO_BUF_SIZE];
+            Uart_EchoTail++;
+        }
+        else
+        {
+            //Oldest bytes dropped by caller , skip may reach head before new bytes added.
+            if ((int) (Uart_TxSkip - Uart_TxTail) > 0)
+            {
+                Uart_TxTail = Uart_TxSkip;
+            }
+            if (Uart_TxTail != Uart_TxHead)
+            {
+                UART_TXBUF = Uart_TxBuffer[Uart_TxTail & UART_TX_MASK];
+                Uart_TxTail++;
+            }
+            else
+            {
+                UART_IE &= ~UCTXIE;
+            }
+        }
         break;
     default:
         break;
     }
 }
 
+/*! Send 1 byte of TX ring by polling , when TX ISR can not run (interrupt disabled). */
+static void Uart_pollTx(void)
+{
+    if ((int) (Uart_TxSkip - Uart_TxTail) > 0)
+    {
+        Uart_TxTail = Uart_TxSkip;
+    }
+    if ((Uart_TxTail != Uart_TxHead) && (UART_IFG & UCTXIFG))
+    {
+        UART_TXBUF = Uart_TxBuffer[Uart_TxTail & UART_TX_MASK];
+        Uart_TxTail++;
+    }
+}
+
+/*! Bytes waiting in TX ring , bytes dropped but not skipped by ISR yet are not counted. */
+static unsigned int Uart_getTxUsed(void)
+{
+    unsigned int tail = Uart_TxTail;
+
+    if ((int) (Uart_TxSkip - tail) > 0)
+    {
+        tail = Uart_TxSkip;
+    }
+    return Uart_TxHead - tail;
+}
+
+/*! Wait TX ring has space of len bytes. */
+static void Uart_waitTxSpace(unsigned int len)
+{
+    while ((unsigned int) (UART_TX_BUF_SIZE - Uart_getTxUsed()) < len)
+    {
+        if (!(__get_SR_register() & GIE))
+        {
+            Uart_pollTx();
+        }
+    }
+}
+
+/*! Worst TX bit edge error of 1 frame , unit SMCLK x baudrate (1 bit = SMCLK_F). */
+static long Uart_calcError(unsigned long baudrate, unsigned int br, unsigned char brf, unsigned char brs,
+                           unsigned char os16)
+{
+    unsigned long clk = 0;
+    long err, worst = 0;
+    unsigned char i, m;
+
+    for (i = 0; i < UART_FRAME_BIT; i++)
+    {
+        m = (UART_BRS_PATTERN[brs] >> (i & 0x07)) & 0x01;
+        clk += os16 ? ((16 + m) * (unsigned long) br + brf) : (br + m);
+        err = (long) (clk * baudrate - (i + 1) * (unsigned long) SMCLK_F);
+        if ((err < 0 ? -err : err) > (worst < 0 ? -worst : worst))
+        {
+            worst = err;
+        }
+    }
+    return worst;
+}
+
+/*! Search Baud-Rate generator setting of the smallest TX bit error. */
+static void Uart_searchBaud(unsigned long baudrate, tUart_Baud *baud)
+{
+    unsigned long n = SMCLK_F / baudrate;
+    unsigned int br;
+    unsigned char brf, brs, os16;
+    long err, best = 0x7FFFFFFF;
+
+    //Oversampling (N >= 16) first , RX majority vote is better. Low-frequency mode is used only when error is smaller.
+    for (os16 = 2; os16-- > 0;)
+    {
+        unsigned int br_min = os16 ? n / 16 : n;
+        unsigned char brf_max = os16 ? 16 : 1;
+        if (os16 && (n < 16))
+        {
+            continue;
+        }
+        for (br = br_min ? br_min : 1; br <= br_min + 1; br++)
+        {
+            for (brf = 0; brf < brf_max; brf++)
+            {
+                for (brs = 0; brs < 8; brs++)
+                {
+                    err = Uart_calcError(baudrate, br, brf, brs, os16);
+                    if ((err < 0 ? -err : err) < best)
+                    {
+                        best = err < 0 ? -err : err;
+                        baud->ErrMax = err / (long) (SMCLK_F / 1000);
+                        baud->Br = br;
+                        baud->Brf = brf;
+                        baud->Brs = brs;
+                        baud->Os16 = os16;
+                    }
+                }
+            }
+        }
+    }
+
+    //Average bit = BR + BRS / 8 or 16 x BR + BRF + BR x BRS / 8 BRCLK.
+    baud->Baudrate = baudrate;
+    baud->Actual = SMCLK_F * 8UL
+            / (baud->Os16 ? (8UL * (16UL * baud->Br + baud->Brf) + (unsigned long) baud->Br * baud->Brs) :
+                            (8UL * baud->Br + baud->Brs));
+}
+
+/*! Write Baud-Rate generator , RX interrupt is enabled again after reset. */
+static void Uart_applyBaud(const tUart_Baud *baud)
+{
+    UART_CTL1 |= UCSWRST;                   // **Put state machine in reset**
+    UART_BR0 = baud->Br & 0xFF;             // Baud-Rate Low byte
+    UART_BR1 = baud->Br >> 8;               // Baud-Rate High byte
+    UART_MCTL = UCBRS_1 * baud->Brs + UCBRF_1 * baud->Brf + (baud->Os16 ? UCOS16 : 0);  // Modulation
+    UART_CTL1 &= ~UCSWRST;                  // **Initialize USCI state machine**
+    UART_IE |= UCRXIE;                      // Enable UART RX interrupt
+    Uart_Baud = *baud;
+}
+
 /*****************************************************************************
  * External Functions
  *****************************************************************************/
 void Uart_init(unsigned long baudrate)
 {
-    //Calculate Baud-Rate
-    unsigned long br = SMCLK_F / baudrate;
-    unsigned long brs = 8 * (SMCLK_F - br * baudrate) / baudrate;
+    tUart_Baud baud;
 
-    //Initial UART
+    //Initial UART , Baud-Rate is set even when error is large.
     URAT_SET_GPIO;                          // Set GPIO as TX/RX
     UART_CTL1 |= UCSWRST;                   // **Put state machine in reset**
     UART_CTL1 |= UCSSEL__SMCLK;             // Clock source = SMCLK
-    UART_BR0 = br & 0xFF;                   // Baud-Rate Low byte
-    UART_BR1 = br >> 8;                     // Baud-Rate High byte
-    UART_MCTL |= UCBRS_1 * brs + UCBRF_0;   // Baud-Rate Second stage
-    UART_CTL1 &= ~UCSWRST;                  // **Initialize USCI state machine**
-    UART_IE |= UCRXIE;                      // Enable UART RX interrupt
+    Uart_searchBaud(baudrate, &baud);
+    Uart_applyBaud(&baud);
 }
 
-/*! Put 1 char to UART TX. */
-void Uart_putc(char byte)
+int Uart_setBaud(unsigned long baudrate)
 {
-    while (!(UART_IFG & UCTXIFG))
+    tUart_Baud baud;
+
+    if ((baudrate == 0) || (SMCLK_F / baudrate > 0xFFFF))
     {
-        ;
+        return 0x7FFF;
+    }
+    Uart_searchBaud(baudrate, &baud);
+    if ((baud.ErrMax > UART_BAUD_ERR_MAX) || (baud.ErrMax < -UART_BAUD_ERR_MAX))
+    {
+        return baud.ErrMax;
     }
-    UART_TXBUF = byte;
+    Uart_flush();
+    Uart_applyBaud(&baud);
+    return baud.ErrMax;
+}
+
+tUart_Baud *Uart_getBaud(void)
+{
+    return &Uart_Baud;
+}
+
+/*! Put 1 char to UART TX. */
+void Uart_putc(char byte)
+{
+    Uart_write(&byte, 1);
 }
 
 /*! Put string (end with 0x00) to UART TX. */
 unsigned char Uart_puts(char *string)
 {
-    unsigned char i, len;
-    len = strlen(string);
-    for (i = 0; i < len; i++)
+    return Uart_write(string, strlen(string));
+}
+
+/*! Copy bytes to TX ring , start TX ISR. */
+unsigned int Uart_write(const char *s, unsigned int len)
+{
+    unsigned int space, pos, first;
+
+    if (len == 0)
     {
-        Uart_putc(string[i]);
+        return 0;
     }
+
+    space = UART_TX_BUF_SIZE - Uart_getTxUsed();
+    if (space < len)
+    {
+        Uart_TxStat.DropWrite++;
+        switch (Uart_TxPolicy)
+        {
+        case UART_TX_BLOCK:
+            //Longer than ring , sent in pieces.
+            Uart_TxStat.DropWrite--;
+            Uart_TxStat.BlockCount++;
+            while (len > UART_TX_BUF_SIZE)
+            {
+                Uart_write(s, UART_TX_BUF_SIZE);
+                s += UART_TX_BUF_SIZE;
+                len -= UART_TX_BUF_SIZE;
+            }
+            Uart_waitTxSpace(len);
+            break;
+        case UART_TX_DROP_OLDEST:
+        {
+            //Keep the latest UART_TX_BUF_SIZE bytes.
+            if (len > UART_TX_BUF_SIZE)
+            {
+                Uart_TxStat.DropByte += len - UART_TX_BUF_SIZE;
+                s += len - UART_TX_BUF_SIZE;
+                len = UART_TX_BUF_SIZE;
+            }
+            //Tail is owned by ISR , skip is published before the old bytes are overwritten.
+            space = UART_TX_BUF_SIZE - Uart_getTxUsed();
+            if (space < len)
+            {
+                Uart_TxSkip = Uart_TxHead + len - UART_TX_BUF_SIZE;
+                Uart_TxStat.DropByte += len - space;
+            }
+            break;
+        }
+        case UART_TX_DROP:
+        default:
+            Uart_TxStat.DropByte += len - space;
+            len = space;
+            break;
+        }
+    }
+
+    //Copy in 2 pieces when wrapping.
+    pos = Uart_TxHead & UART_TX_MASK;
+    first = UART_TX_BUF_SIZE - pos;
+    if (first >= len)
+    {
+        memcpy(&Uart_TxBuffer[pos], s, len);
+    }
+    else
+    {
+        memcpy(&Uart_TxBuffer[pos], s, first);
+        memcpy(Uart_TxBuffer, s + first, len - first);
+    }
+    Uart_TxHead += len;
+
+    if (Uart_getTxUsed() > Uart_TxStat.MaxUsed)
+    {
+        Uart_TxStat.MaxUsed = Uart_getTxUsed();
+    }
+    UART_IE |= UCTXIE;
     return len;
 }
 
+unsigned int Uart_getTxFree(void)
+{
+    return UART_TX_BUF_SIZE - Uart_getTxUsed();
+}
+
+/*! Wait TX ring empty & last byte out. */
+void Uart_flush(void)
+{
+    Uart_waitTxSpace(UART_TX_BUF_SIZE);
+    while ((Uart_EchoHead != Uart_EchoTail) && (__get_SR_register() & GIE))
+    {
+        ;
+    }
+    while (UART_STAT & UCBUSY)
+    {
+        ;
+    }
+}
+
+UART_TX_POLICY Uart_setTxPolicy(UART_TX_POLICY policy)
+{
+    UART_TX_POLICY old = Uart_TxPolicy;
+    Uart_TxPolicy = policy;
+    return old;
+}
+
+tUart_TxStat *Uart_getTxStat(void)
+{
+    return &Uart_TxStat;
+}
+
 /*! Return last received data */
 unsigned char Uart_getc(void)
 {
     return UART_RXBUF;
 }
 
-/*! Copy all buffered data out. */
-unsigned int Uart_gets(unsigned char *s)
+/*! Copy RX ring from tail to end out , move tail. */
+static unsigned int Uart_readRx(unsigned char *s, unsigned int end)
 {
-    if (Uart_RxCount)
+    unsigned int len = end - Uart_RxTail;
+    unsigned int pos = Uart_RxTail & UART_RX_MASK;
+    unsigned int first = UART_RX_BUF_SIZE - pos;
+
+    //Copy in 2 pieces when wrapping.
+    if (first >= len)
+    {
+        memcpy(s, &Uart_RxBuffer[pos], len);
+    }
+    else
     {
-        memcpy(s, Uart_RxBuffer, Uart_RxCount);
+        memcpy(s, &Uart_RxBuffer[pos], first);
+        memcpy(s + first, Uart_RxBuffer, len - first);
     }
-    return Uart_RxCount;
+    Uart_RxTail = end;
+    return len;
 }
 
-/*! Copy 1 line data out (before '\r'). */
+/*! Copy all buffered data out. */
+unsigned int Uart_gets(unsigned char *s)
+{
+    unsigned int len = Uart_readRx(s, Uart_RxHead);
+
+    //Lines are taken too.
+    Uart_RxLineTail = Uart_RxLineHead;
+    return len;
+}
+
+/*! Copy 1 line data out (till '\r'). */
 unsigned int Uart_getl(unsigned char *s)
 {
-    unsigned int i = 0;
-    unsigned int pos = 0;
-    //Find '\r' position
-    for (i = 0; i < Uart_RxCount; i++)
+    while (Uart_RxLineTail != Uart_RxLineHead)
     {
-        if (Uart_RxBuffer[i] == '\r')
+        unsigned int end = Uart_RxLineEnd[Uart_RxLineTail & UART_RX_LINE_MASK];
+        Uart_RxLineTail++;
+
+        //Line already removed by Uart_clear.
+        if ((int) (end - Uart_RxTail) <= 0)
         {
-            pos = i;
+            continue;
         }
+
+        //'\n' of "\r\n" is the start of next line.
+        while ((Uart_RxTail != end) && (Uart_RxBuffer[Uart_RxTail & UART_RX_MASK] == '\n'))
+        {
+            Uart_RxTail++;
+        }
+        return Uart_readRx(s, end);
     }
-    //Copy data before '\r'
-    if (pos)
-    {
-        memcpy(s, Uart_RxBuffer, pos);
-    }
-    return pos;
+    return 0;
 }
 
 /*! Clear UART RX buffer.  */
 void Uart_clear(void)
 {
-    memset(Uart_RxBuffer, 0x00, Uart_RxCount);
-    Uart_RxCount = 0;
+    //Line ends first , lines recorded between 2 reads are skipped by Uart_getl.
+    Uart_RxLineTail = Uart_RxLineHead;
+    Uart_RxTail = Uart_RxHead;
+}
+
+tUart_RxStat *Uart_getRxStat(void)
+{
+    return &Uart_RxStat;
 }
 
 /*! Print using UART. The same as printf.
  *  Use this when UART_PRINTF_OVERRIDE = 0 when you don't want to override original printf
+ *  Buffer is larger than C stack , not reentrant , do not call from ISR.
  */
 void Uart_print(char *fmt, ...)
 {
     va_list ap;
-    char string[UART_TX_BUF_SIZE];
+    static char string[UART_TX_BUF_SIZE];
     va_start(ap, fmt);
     vsprintf(string, fmt, ap);
     Uart_puts(string);
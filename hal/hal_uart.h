@@ -15,8 +15,52 @@
 #include <stdio.h>
 
 #define UART_PRINTF_OVERRIDE    1       //1: printf override to UART  0: printf route to JTAG
-#define UART_RX_BUF_SIZE        256     //TX buffer size. Maximum size for sending at 1 time.
-#define UART_TX_BUF_SIZE        256     //TX buffer size. Maximum size for receiving at 1 time.
+#define UART_RX_BUF_SIZE        256     //RX ring size , power of 2. Maximum line length.
+#define UART_RX_LINE_MAX        8       //Complete lines waiting in RX ring , power of 2.
+#define UART_RX_ECHO            1       //1 : Received bytes are echoed through TX ring.
+#define UART_TX_BUF_SIZE        256     //TX ring size , power of 2. Drained by UART TX ISR.
+#define UART_TX_POLICY_DEFAULT  UART_TX_DROP
+#define UART_BAUD_ERR_MAX       50      //Maximum TX bit error , unit 0.1% bit. Baudrate with larger error is rejected.
+
+/* TX ring overflow policy.
+ * UART_TX_DROP         : New bytes not fitting the ring are dropped , never waits.
+ * UART_TX_BLOCK        : Wait until ring has space , same as the old blocking UART.
+ * UART_TX_DROP_OLDEST  : Oldest bytes not sent yet are dropped , the latest output is kept.
+ */
+typedef enum UART_TX_POLICY
+{
+    UART_TX_DROP = 0x00, UART_TX_BLOCK = 0x01, UART_TX_DROP_OLDEST = 0x02
+} UART_TX_POLICY;
+
+typedef struct tUart_TxStat
+{
+    unsigned int DropByte;      //Bytes dropped by overflow.
+    unsigned int DropWrite;     //Writes hit overflow , 1 printf = 1 write.
+    unsigned int BlockCount;    //Writes waited for space.
+    unsigned int MaxUsed;       //Peak bytes in TX ring.
+} tUart_TxStat;
+
+typedef struct tUart_RxStat
+{
+    unsigned int DropByte;      //Bytes dropped , RX ring full.
+    unsigned int LineCut;       //Lines cut at UART_RX_BUF_SIZE without '\r'.
+    unsigned int LineDrop;      //Lines received when UART_RX_LINE_MAX lines are waiting , merged into next.
+} tUart_RxStat;
+
+/* Baud-Rate generator setting , chosen by Uart_setBaud.
+ * ErrMax is the worst TX bit edge error over 1 frame (start + 8 data + stop) ,
+ * unit 0.1% bit , + = late. Same calculation as the UCBRSx / UCBRFx tables of TI user guide.
+ */
+typedef struct tUart_Baud
+{
+    unsigned long Baudrate;     //Requested.
+    unsigned long Actual;       //Average of 1 frame.
+    int ErrMax;
+    unsigned int Br;            //UCBRx.
+    unsigned char Brf;          //UCBRFx , oversampling mode only.
+    unsigned char Brs;          //UCBRSx.
+    unsigned char Os16;         //1 : Oversampling mode (UCOS16)  0 : Low-frequency mode.
+} tUart_Baud;
 
 /******************************************************************************
  * @fn      Uart_init
@@ -25,20 +69,71 @@
  *****************************************************************************/
 extern void Uart_init(unsigned long baudrate);
 
+/******************************************************************************
+ * @fn      Uart_setBaud
+ * @brief   Change baudrate at runtime , TX ring is flushed at old baudrate first.
+ * @note    Low-frequency & oversampling modes are searched for the smallest TX bit error.
+ *          Baudrate is not changed when error is larger than UART_BAUD_ERR_MAX.
+ * @param   baudrate    is the baudrate of UART.
+ * @return  TX bit error of the best setting found , unit 0.1% bit , 0x7FFF = baudrate out of range.
+ *****************************************************************************/
+extern int Uart_setBaud(unsigned long baudrate);
+
+/******************************************************************************
+ * @fn      Uart_getBaud
+ * @return  Pointer to Baud-Rate generator setting in use.
+ *****************************************************************************/
+extern tUart_Baud *Uart_getBaud(void);
+
 /******************************************************************************
  * @fn      Uart_putc
- * @brief   Put 1 char to UART TX.
+ * @brief   Put 1 char to UART TX ring.
  * @param   byte    the byte to be transmitted.
  *****************************************************************************/
 extern void Uart_putc(char byte);
 
 /******************************************************************************
  * @fn      Uart_puts
- * @brief   Put string to UART TX.
+ * @brief   Put string to UART TX ring.
  * @param   string    the pointer string to be transmitted.
  *****************************************************************************/
 extern unsigned char Uart_puts(char *string);
 
+/******************************************************************************
+ * @fn      Uart_write
+ * @brief   Copy bytes to UART TX ring , sent by UART TX ISR.
+ * @note    When the ring is full , bytes are handled by TX overflow policy.
+ * @param   s   is the pointer to bytes to be transmitted.
+ * @param   len is the number of bytes.
+ * @return  The number of bytes put into ring.
+ *****************************************************************************/
+extern unsigned int Uart_write(const char *s, unsigned int len);
+
+/******************************************************************************
+ * @fn      Uart_getTxFree
+ * @return  Free bytes of TX ring , a write not longer than this is never dropped or blocked.
+ *****************************************************************************/
+extern unsigned int Uart_getTxFree(void);
+
+/******************************************************************************
+ * @fn      Uart_flush
+ * @brief   Wait all bytes in TX ring sent out.
+ *****************************************************************************/
+extern void Uart_flush(void);
+
+/******************************************************************************
+ * @fn      Uart_setTxPolicy
+ * @brief   Set TX ring overflow policy , default UART_TX_POLICY_DEFAULT.
+ * @return  Policy before change.
+ *****************************************************************************/
+extern UART_TX_POLICY Uart_setTxPolicy(UART_TX_POLICY policy);
+
+/******************************************************************************
+ * @fn      Uart_getTxStat
+ * @return  Pointer to TX ring statistics.
+ *****************************************************************************/
+extern tUart_TxStat *Uart_getTxStat(void);
+
 /******************************************************************************
  * @fn      Uart_getc
  * @brief   Get 1 char from UART RX.
@@ -48,31 +143,38 @@ extern unsigned char Uart_getc(void);
 
 /******************************************************************************
  * @fn      Uart_gets
- * @brief   Get string from UART RX (buffered).
- * @note    If buffer is full ,data will be override.
- * @param   s is the pointer to destination of data copy buffer.
+ * @brief   Get all bytes from UART RX ring , bytes are removed from ring.
+ * @note    If ring is full , new bytes are dropped.
+ * @param   s is the pointer to destination of data copy buffer , UART_RX_BUF_SIZE bytes.
  * @return  The number of bytes received.
  *****************************************************************************/
 extern unsigned int Uart_gets(unsigned char *s);
 
 /******************************************************************************
  * @fn      Uart_getl
- * @brief   Get 1 line of string ,till get '\r'.
- * @param   s is the pointer to destination of data copy buffer.
- * @return  The number of bytes received.
+ * @brief   Get 1 line of string , till '\r' (included) , the line is removed from ring.
+ * @note    Line ends are recorded by RX ISR , no search. '\n' at line start is skipped.
+ * @param   s is the pointer to destination of data copy buffer , UART_RX_BUF_SIZE bytes.
+ * @return  The number of bytes of line , 0 = no complete line , 1 = empty line ("\r").
  *****************************************************************************/
 extern unsigned int Uart_getl(unsigned char *s);
 
 /******************************************************************************
  * @fn      Uart_clear
- * @brief   Clear UART buffer & count.
+ * @brief   Clear UART RX ring , bytes received after the call are kept.
  *****************************************************************************/
 extern void Uart_clear(void);
 
+/******************************************************************************
+ * @fn      Uart_getRxStat
+ * @return  Pointer to RX ring statistics.
+ *****************************************************************************/
+extern tUart_RxStat *Uart_getRxStat(void);
+
 /******************************************************************************
  * @fn      Uart_print
  * @brief   C/C++ style print function , usage is the same as printf().
- * @note    Only %x %d %s are supported.
+ * @note    Only %x %d %s are supported. Not reentrant , main loop only.
  * @example Uart_print("This is a test %d .\r" , i++);
  *****************************************************************************/
 void Uart_print(char *fmt, ...);
@@ -64,6 +64,7 @@ MEMORY
     INFOD                   : origin = 0x1800, length = 0x0080
     FLASH                   : origin = 0x4400, length = 0xBB80
     FLASH2                  : origin = 0x10000,length = 0x14400
+    DLOG                    : origin = 0x0200, length = 0x1600   /* Not on chip , deferred log format ID space */
     INT00                   : origin = 0xFF80, length = 0x0002
     INT01                   : origin = 0xFF82, length = 0x0002
     INT02                   : origin = 0xFF84, length = 0x0002
@@ -155,6 +156,7 @@ SECTIONS
     .const      : {} >> FLASH | FLASH2      /* Constant data                     */
 #endif
     .cio        : {} > RAM                  /* C I/O Buffer                      */
+    .usbram     : {} > USBRAM type=NOINIT   /* USB not used , large buffers      */
 
     .pinit      : {} > FLASH                /* C++ Constructor tables            */
     .binit      : {} > FLASH                /* Boot-time Initialization tables   */
@@ -176,6 +178,8 @@ SECTIONS
     .infoC     : {} > INFOC
     .infoD     : {} > INFOD
 
+    .dlog       : {} > DLOG type=COPY       /* Deferred log format strings , kept in output file only */
+
     /* MSP430 Interrupt vectors          */
     .int00       : {}               > INT00
     .int01       : {}               > INT01
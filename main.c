@@ -12,8 +12,21 @@ PLAYER_PARAM gPlayerParam =
         .pout_model = OUT_D8_P8,
         .psync_mode = PSYNC_OUT_ON_VSYNC_OUT,
         .ptest_pattern =PTP_RUN_HORSE,
+        .presample_mode = PRS_DISABLE,
+        .pfrc_mode = PFRC_REPEAT,
+        .pin_check = PLAYER_IN_CHECK_LEN,
+        .phold_ms = 1000,
+        .pfade_frames = 120,
+        .presume_frames = 8,
+        .psafe_duty = 0x0200,
 };
 uint8_t buf[10];
+
+//Test ONLY , result of queued I2C read.
+void Main_I2cDone(I2C_MASTER_RET ret, void *arg)
+{
+    printf("\r\n I2C read result 0x%x", ret);
+}
 //This is a git test
 
 //This is also at test
@@ -23,6 +36,8 @@ int main(void)
     WATCHDOG_FEED;
     Mcu_init(ON);
     APP_PLIMIT_init(1);
+    App_Cmd_init();
+    App_Player_setWorkParam(&gPlayerParam);
 
     //Test ONLY
     PwmOut_setOutput(1, 60, 128);
@@ -34,16 +49,14 @@ int main(void)
 
         App_Cmd_Uart();
         App_Cmd_I2c();
+        App_Telem_service();
+        I2cMaster_service();
 
-        uint8_t result;
-
-        //result = I2cMaster_write(0x48,"ABCDEFG",1);
-
-        //printf("\r\n I2C write result 0x%x",result);
-
-        result = I2cMaster_wread(0x48,"ABCDEFG",7,buf,1);
-
-        printf("\r\n I2C read result 0x%x",result);
+        //Queued , result printed by callback , loop is not blocked by a missing slave.
+        if (!I2cMaster_isBusy())
+        {
+            I2cMaster_submit(0x48, (const uint8_t *) "ABCDEFG", 7, buf, 1, 10, Main_I2cDone, 0);
+        }
 
         //App_Player(&gPlayerParam);
 
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Decode SkyDog2 binary telemetry (app/app_telem) from a UART capture into CSV.
+
+Packet (before framing) , little endian :
+    [Type:1] [Seq:1] [Frame:2] [Offset:1] [Count:1] [Value:2 x Count] [CRC16:2]
+Framing : COBS encoded , 0x00 before and after. CRC16 CCITT (poly 0x1021 , init 0xFFFF).
+Text printed on the same UART fails the CRC check and is counted as bad frames.
+
+Usage :
+    telem_decode.py capture.bin [-o prefix] [--elf firmware.out]
+Output , 1 CSV per packet type found :
+    <prefix>_duty.csv / _limit.csv / _temp.csv : frame , ch0 , ch1 ...
+    <prefix>_frame.csv / _timing.csv           : frame , named values
+    <prefix>_log.txt                           : deferred log (hal_dlog) , formatted with strings of --elf
+Deferred log record : [Arg amount:1] [Format ID:2] [Tick:4] [Arg:4 x Arg amount] ,
+Format ID is the address of the format string in section .dlog , %s args are addresses of constant strings.
+"""
+
+import argparse
+import csv
+import re
+import struct
+import sys
+
+TYPES = {
+    0x01: ("duty", None),
+    0x02: ("limit", None),
+    0x03: ("temp", None),
+    0x04: ("frame", ["in_ok", "in_err", "out_ok", "out_fail", "out_byte", "fault", "uart_drop", "telem_drop"]),
+    0x05: ("timing", ["period_us", "plimit_us", "output_us", "input_us"]),
+}
+LOG_TYPE = 0x06
+HEAD = struct.Struct("<BBHBB")
+CONV = re.compile(r"%([-+ 0#]*\d*(?:\.\d+)?)([hl]*)([diuxXcsp%])")
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def packets(raw, stat):
+    for chunk in raw.split(b"\x00"):
+        if not chunk:
+            continue
+        pkt = cobs_decode(chunk)
+        if pkt is None or len(pkt) < HEAD.size + 2:
+            stat["bad"] += 1
+            continue
+        body, crc = pkt[:-2], struct.unpack("<H", pkt[-2:])[0]
+        if crc16(body) != crc:
+            stat["bad"] += 1
+            continue
+        ptype, seq, frame, offset, count = HEAD.unpack_from(body)
+        if (ptype not in TYPES and ptype != LOG_TYPE) or len(body) != HEAD.size + count * 2:
+            stat["bad"] += 1
+            continue
+        values = struct.unpack_from("<%dH" % count, body, HEAD.size)
+        if stat["seq"] is not None:
+            stat["lost"] += (seq - stat["seq"] - 1) & 0xFF
+        stat["seq"] = seq
+        stat["ok"] += 1
+        yield ptype, frame, offset, values
+
+
+class Elf:
+    """Address -> bytes of ELF sections , for .dlog format strings & constant %s args."""
+
+    def __init__(self, path):
+        self.sections = []
+        with open(path, "rb") as f:
+            d = f.read()
+        if d[:4] != b"\x7fELF":
+            raise ValueError("%s : not an ELF file" % path)
+        is64 = d[4] == 2
+        end = "<" if d[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(end + "Q", d, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", d, 0x3A)
+            fmt = end + "IIQQQQ"
+        else:
+            shoff, = struct.unpack_from(end + "I", d, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", d, 0x2E)
+            fmt = end + "IIIIII"
+        heads = [struct.unpack_from(fmt, d, shoff + i * shentsize) for i in range(shnum)]
+        stroff = heads[shstrndx][4]
+        for name, stype, flags, addr, offset, size in heads:
+            name = d[stroff + name:d.index(b"\0", stroff + name)].decode()
+            if stype == 8 or size == 0:     # SHT_NOBITS
+                continue
+            if (flags & 0x2) or name == ".dlog":
+                self.sections.append((addr, d[offset:offset + size]))
+
+    def string(self, addr):
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                s = data[addr - base:]
+                return s[:s.index(b"\0")].decode("latin-1") if b"\0" in s else s.decode("latin-1")
+        return "<0x%x>" % addr
+
+
+def format_log(elf, fid, args):
+    fmt = elf.string(fid) if elf else "<fmt 0x%x>" % fid
+    args = list(args)
+
+    def conv(m):
+        flags, size, c = m.groups()
+        if c == "%":
+            return "%"
+        v = args.pop(0) if args else 0
+        if "l" not in size:
+            v &= 0xFFFF
+            if c in "di" and v >= 0x8000:
+                v -= 0x10000
+        elif c not in "di":
+            v &= 0xFFFFFFFF
+        if c == "s":
+            return elf.string(v & 0xFFFFF) if elf else "<0x%x>" % v
+        if c == "c":
+            return chr(v & 0xFF)
+        if c == "p":
+            return "0x%x" % v
+        return ("%" + flags + ("d" if c == "u" else c)) % v
+
+    text = CONV.sub(conv, fmt)
+    if not elf and args:
+        text += " " + " ".join(str(a) for a in args)
+    return text
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("capture", help="raw UART capture file")
+    ap.add_argument("-o", "--prefix", default="telem", help="output CSV prefix (default: telem)")
+    ap.add_argument("--elf", help="firmware output file , for deferred log strings")
+    ap.add_argument("--tick-hz", type=float, default=1048576.0, help="Clock_getTick frequency (default: 1048576)")
+    args = ap.parse_args()
+    elf = Elf(args.elf) if args.elf else None
+
+    with open(args.capture, "rb") as f:
+        raw = f.read()
+
+    stat = {"ok": 0, "bad": 0, "lost": 0, "seq": None}
+    rows = {}   # type -> {frame: [values]} , channel chunks are merged by offset.
+    logs = []
+    for ptype, frame, offset, values in packets(raw, stat):
+        if ptype == LOG_TYPE:
+            rec = struct.pack("<%dH" % len(values), *values)
+            narg, fid, tick = struct.unpack_from("<BHI", rec)
+            if len(rec) < 7 + narg * 4:
+                stat["bad"] += 1
+                continue
+            logargs = struct.unpack_from("<%di" % narg, rec, 7)
+            logs.append("[%12.6f] %s" % (tick / args.tick_hz, format_log(elf, fid, logargs).strip("\r\n")))
+            continue
+        row = rows.setdefault(ptype, {}).setdefault(frame, [])
+        if len(row) < offset + len(values):
+            row.extend([""] * (offset + len(values) - len(row)))
+        row[offset:offset + len(values)] = values
+
+    for ptype, frames in sorted(rows.items()):
+        name, fields = TYPES[ptype]
+        width = max(len(v) for v in frames.values())
+        header = fields if fields else ["ch%d" % i for i in range(width)]
+        path = "%s_%s.csv" % (args.prefix, name)
+        with open(path, "w", newline="") as f:
+            w = csv.writer(f)
+            w.writerow(["frame"] + header)
+            for frame in sorted(frames):
+                w.writerow([frame] + frames[frame] + [""] * (width - len(frames[frame])))
+        print("%s : %d frames" % (path, len(frames)))
+
+    if logs:
+        path = "%s_log.txt" % args.prefix
+        with open(path, "w") as f:
+            f.write("\n".join(logs) + "\n")
+        print("%s : %d logs" % (path, len(logs)))
+
+    print("packets ok = %d , bad / text = %d , lost = %d" % (stat["ok"], stat["bad"], stat["lost"]), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()